@@ -0,0 +1,98 @@
+#ifndef ALIGNED_ARRAY_H
+#define ALIGNED_ARRAY_H
+
+#include <string.h>
+#include <stdint.h>
+#include "Header.h"
+
+// Rozmiar linii pamieci podrecznej, do ktorej wyrownywane sa tablice.
+#define CACHE_LINE_SIZE 64
+
+// Tablica o rozmiarze ustalanym w czasie dzialania programu,
+// umieszczona na stercie i wyrownana do poczatku linii pamieci podrecznej.
+template <typename T> class AlignedArray
+{
+public:
+	DEF AlignedArray()
+	{
+		raw = nullptr;
+		array = nullptr;
+		n = 0;
+	}
+
+	DEF explicit AlignedArray(int size)
+	{
+		raw = nullptr;
+		array = nullptr;
+		n = 0;
+		resize(size);
+	}
+
+	DEF AlignedArray(const AlignedArray &other)
+	{
+		raw = nullptr;
+		array = nullptr;
+		n = 0;
+		resize(other.n);
+		memcpy(array, other.array, sizeof(T) * n);
+	}
+
+	DEF ~AlignedArray()
+	{
+		delete[] raw;
+	}
+
+	DEF AlignedArray &operator=(const AlignedArray &other)
+	{
+		if (this != &other)
+		{
+			resize(other.n);
+			memcpy(array, other.array, sizeof(T) * n);
+		}
+		return *this;
+	}
+
+	// Zmienia rozmiar tablicy. Poprzednia zawartosc nie jest zachowywana,
+	// nowe elementy sa wyzerowane.
+	DEF void resize(int size)
+	{
+		delete[] raw;
+		n = size;
+		raw = new char[sizeof(T) * (size > 0 ? size : 1) + CACHE_LINE_SIZE - 1];
+		uintptr_t address = reinterpret_cast<uintptr_t>(raw);
+		address = (address + CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CACHE_LINE_SIZE - 1);
+		array = reinterpret_cast<T *>(address);
+		memset(array, 0, sizeof(T) * n);
+	}
+
+	DEF int size() const
+	{
+		return n;
+	}
+
+	DEF T *get()
+	{
+		return array;
+	}
+
+	DEF const T *get() const
+	{
+		return array;
+	}
+
+	DEF T &operator[](int index)
+	{
+		return array[index];
+	}
+
+	DEF const T &operator[](int index) const
+	{
+		return array[index];
+	}
+private:
+	char *raw;
+	T *array;
+	int n;
+};
+
+#endif //ALIGNED_ARRAY_H
@@ -670,6 +670,14 @@ public:
 	DEF void setWeights(Board::EVALUATION_TYPE *weights)
 	{
 		memcpy(getWeights(), weights, sizeof(Board::EVALUATION_TYPE) * getNWeights());
+		// kolejni gracze otrzymaja nowe wagi, dotychczasowi zachowaja swoje
+		delete prototype;
+		prototype = nullptr;
+	}
+
+	DEF ~NTupleLoader()
+	{
+		delete prototype;
 	}
 
 	DEF int getNTuples()
@@ -771,7 +779,7 @@ public:
 	}
 protected:
 	DEF NTupleLoader(char *data, unsigned size, bool ownData)
-		: PlayerLoader(data, size, ownData) { }
+		: PlayerLoader(data, size, ownData), prototype(nullptr) { }
 private:
 	DEF static char *getData(int nFields, int nWeights, int nTuples)
 	{
@@ -809,77 +817,17 @@ private:
 
 	DEF OthelloPlayer *getNTuplePlayer(int seed, bool negated)
 	{
-		OthelloPlayer *player = nullptr;
-
-		player = check<632, 6561, 120, 18>(seed, negated);
+		OthelloPlayer *player = getStaticNTuplePlayer(seed, negated, getNFields(), getNWeights(), getNTuples(), getMaxTuplePerPos(), getFields(), getWeights(), getTuples());
 		if (player != nullptr)
 			return player;
 
-		player = check<624, 1701, 156, 19>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<576, 8748, 96, 30>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<576, 8748, 96, 22>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<540, 648, 180, 13>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<520, 3402, 104, 16>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<488, 4698, 96, 20>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<480, 288, 240, 11>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<464, 3240, 96, 36>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<64, 192, 64, 1>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<64, 30, 64, 1>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<8, 18, 4, 3>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		player = check<6, 9, 3, 1>(seed, negated);
-		if (player != nullptr)
-			return player;
-
-		return nullptr;
+		if (prototype == nullptr)
+			prototype = new DynamicNTuples(getNWeights(), getNTuples(), getFields(), getWeights(), getTuples());
+		return new DynamicNTuplePlayer(seed, negated, *prototype);
 	}
 
-	template <int N_FIELDS, int N_WEIGHTS, int N_TUPLES, int TUPLES_PER_POS>
-	DEF OthelloPlayer *check(int seed, bool negated)
-	{
-		if (getNFields() == N_FIELDS &&
-			getNWeights() == N_WEIGHTS &&
-			getNTuples() == N_TUPLES &&
-			getMaxTuplePerPos() == TUPLES_PER_POS)
-		{
-			OthelloPlayer *player = new NTuplePlayer<N_FIELDS, N_WEIGHTS, N_TUPLES, TUPLES_PER_POS>(seed, negated, getFields(), getWeights(), getTuples());
-			return player;
-		}
-
-		return nullptr;
-	}
+	// Siec wspoldzielona przez wszystkich graczy utworzonych z tego pliku.
+	DynamicNTuples *prototype;
 };
 
 DEF AnyLoader *AnyLoader::getLoader(char *data, unsigned dataSize, bool own)
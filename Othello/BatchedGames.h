@@ -0,0 +1,618 @@
+#ifndef BATCHED_GAMES_H
+#define BATCHED_GAMES_H
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif // __AVX2__
+#include "Header.h"
+#include "Board.h"
+#include "AlignedArray.h"
+#include "DynamicNTuples.h"
+#include "OthelloPlayer.h"
+#include "AnyLoader.h"
+#include "Random.h"
+
+// Rozgrywa jednoczesnie paczke gier dwoch graczy oceniajacych ruchy siecia krotek
+// (DynamicNTuplePlayer lub WPCPlayer jako 64 krotki jednopolowe), tak jak Othello::play.
+// Gry posuwaja sie w tym samym rytmie: w kazdym kroku wszystkie gry wykonuja ruch
+// tego samego koloru, a oceniany jest naraz k-ty ruch kazdej gry. Stan gier trzymany
+// jest w ukladzie struktury tablic (maski pionow [gra], indeksy krotek [krotka][gra]),
+// wiec ruchy i przejmowane piony wyznaczane sa dla 4 gier, a wagi pobierane dla 8 gier
+// jedna instrukcja AVX2. Bez AVX2 te same petle wykonywane sa skalarnie z tym samym
+// wynikiem. Zakonczona gra zastepowana jest gra od kolejnej planszy.
+// Przebieg gry zalezy tylko od ziarna i numeru planszy, a nie od rozmiaru paczki.
+class BatchedGames
+{
+public:
+	// Liczba gier oceniana jednym rejestrem wektorowym; rozmiar paczki jest jej wielokrotnoscia.
+	static const int GROUP = 8;
+	static const int DEFAULT_BATCH_SIZE = 32;
+
+	// Gracz rozgrywki: ksztalt sieci, wagi w ukladzie sieci (zob. getWeights),
+	// czestosc losowych ruchow i negowanie oceny (tylko grajac bialymi, jak w Othello).
+	struct Player
+	{
+		const NTupleNetwork *network;
+		const Board::EVALUATION_TYPE *weights;
+		float randomMoveFreq;
+		bool negated;
+	};
+
+	BatchedGames(int batchSize = DEFAULT_BATCH_SIZE)
+	{
+		this->batchSize = std::max(GROUP, (batchSize + GROUP - 1) / GROUP * GROUP);
+		nLanes = 0;
+	}
+
+	// Rozgrywa gry czarnych black z bialymi white od kazdej planszy z boards.
+	// results[b] - wynik czarnych (1, 0.5 lub 0) w grze od planszy b; gra od planszy b
+	// korzysta z generatorow o ziarnie seed + b.
+	void play(const Player &black, const Player &white, BoardLoader *boards, unsigned seed, Board::EVALUATION_TYPE *results)
+	{
+		players[0] = &black;
+		players[1] = &white;
+		int nBoards = boards->getNBoards();
+		nLanes = std::min(batchSize, (nBoards + GROUP - 1) / GROUP * GROUP);
+		allocate();
+
+		int next = 0;
+		while (true)
+		{
+			int nActive = 0;
+			for (int l = 0; l < nLanes; l++)
+			{
+				if (games[l] < 0 && next < nBoards)
+					startGame(l, next++, boards, seed);
+				moved[l] = 0;
+				if (games[l] >= 0)
+					nActive++;
+			}
+			if (nActive == 0)
+				break;
+
+			// jak w Othello::play - gra konczy sie, gdy zaden z graczy nie mial ruchu
+			step(0);
+			step(1);
+			for (int l = 0; l < nLanes; l++)
+			{
+				if (games[l] >= 0 && !moved[l])
+				{
+					results[games[l]] = getResult(l);
+					games[l] = -1;
+					pawns[0][l] = 0;
+					pawns[1][l] = 0;
+				}
+			}
+		}
+	}
+
+	// Siec krotek gracza WPCPlayer lub DynamicNTuplePlayer (nullptr - gracz nieobslugiwany).
+	static std::shared_ptr<const NTupleNetwork> getNetwork(OthelloPlayer *player)
+	{
+		DynamicNTuplePlayer *nTuplePlayer = dynamic_cast<DynamicNTuplePlayer *>(player);
+		if (nTuplePlayer != nullptr)
+			return nTuplePlayer->getNTuples().getNetwork();
+		if (dynamic_cast<WPCPlayer *>(player) == nullptr)
+			return std::shared_ptr<const NTupleNetwork>();
+
+		// pole o numerze bitu b jest krotka b z wagami 3b..3b+2
+		Board::INDEX_TYPE fields[64];
+		int tuples[3 * 64];
+		for (int bit = 0; bit < 64; bit++)
+		{
+			fields[bit] = Board::getFieldIndex(bit);
+			tuples[3 * bit] = 1;
+			tuples[3 * bit + 1] = bit;
+			tuples[3 * bit + 2] = 3 * bit;
+		}
+		return std::make_shared<const NTupleNetwork>(3 * 64, 64, fields, tuples);
+	}
+
+	// Wagi sieci getNetwork(player) dla wag gracza w ukladzie getWeights/setWeights.
+	// Dla sieci krotek sa to te same wagi; wagi WPC zamieniane sa w buffer na wagi krotek
+	// (cyfra pola 1 - wartosc, wiec waga cyfry d to (1 - d) razy waga pola).
+	static const Board::EVALUATION_TYPE *getWeights(OthelloPlayer *player, const Board::EVALUATION_TYPE *playerWeights, AlignedArray<Board::EVALUATION_TYPE> &buffer)
+	{
+		if (dynamic_cast<WPCPlayer *>(player) == nullptr)
+			return playerWeights;
+
+		if (buffer.size() != 3 * 64)
+			buffer.resize(3 * 64);
+		for (int bit = 0; bit < 64; bit++)
+		{
+			buffer[3 * bit] = playerWeights[bit];
+			buffer[3 * bit + 1] = 0;
+			buffer[3 * bit + 2] = -playerWeights[bit];
+		}
+		return buffer.get();
+	}
+private:
+	// Pojedyncza maska planszy.
+	struct SingleMask
+	{
+		typedef uint64_t TYPE;
+		static const int N = 1;
+
+		static TYPE load(const uint64_t *p) { return *p; }
+		static void store(uint64_t *p, TYPE value) { *p = value; }
+		static TYPE constant(uint64_t value) { return value; }
+		static TYPE bitAnd(TYPE a, TYPE b) { return a & b; }
+		static TYPE bitOr(TYPE a, TYPE b) { return a | b; }
+		static TYPE bitAndNot(TYPE a, TYPE b) { return a & ~b; }
+		static TYPE lowestBit(TYPE value) { return value & (0 - value); }
+		static TYPE ifNonZero(TYPE test, TYPE value) { return test != 0 ? value : 0; }
+
+		template <int S>
+		static TYPE shift(TYPE value)
+		{
+			return S > 0 ? value << (S > 0 ? S : 0) : value >> (S > 0 ? 0 : -S);
+		}
+	};
+
+#ifdef __AVX2__
+	// Cztery maski planszy w rejestrze AVX2.
+	struct WideMasks
+	{
+		typedef __m256i TYPE;
+		static const int N = 4;
+
+		static TYPE load(const uint64_t *p) { return _mm256_load_si256(reinterpret_cast<const __m256i *>(p)); }
+		static void store(uint64_t *p, TYPE value) { _mm256_store_si256(reinterpret_cast<__m256i *>(p), value); }
+		static TYPE constant(uint64_t value) { return _mm256_set1_epi64x((long long)value); }
+		static TYPE bitAnd(TYPE a, TYPE b) { return _mm256_and_si256(a, b); }
+		static TYPE bitOr(TYPE a, TYPE b) { return _mm256_or_si256(a, b); }
+		// a & ~b
+		static TYPE bitAndNot(TYPE a, TYPE b) { return _mm256_andnot_si256(b, a); }
+		static TYPE lowestBit(TYPE value) { return _mm256_and_si256(value, _mm256_sub_epi64(_mm256_setzero_si256(), value)); }
+		// value, jesli test != 0, w przeciwnym razie 0
+		static TYPE ifNonZero(TYPE test, TYPE value) { return _mm256_andnot_si256(_mm256_cmpeq_epi64(test, _mm256_setzero_si256()), value); }
+
+		template <int S>
+		static TYPE shift(TYPE value)
+		{
+			return S > 0 ? _mm256_slli_epi64(value, S > 0 ? S : 0) : _mm256_srli_epi64(value, S > 0 ? 0 : -S);
+		}
+	};
+
+	typedef WideMasks Masks;
+	// Liczba gier, ktorych ruchy oceniane sa razem.
+	static const int WIDTH = GROUP;
+#else
+	typedef SingleMask Masks;
+	static const int WIDTH = 1;
+#endif // __AVX2__
+
+	int batchSize;
+	// Liczba gier w biezacej paczce (wielokrotnosc GROUP).
+	int nLanes;
+	// Czarni (0) i biali (1) biezacej paczki.
+	const Player *players[2];
+
+	// Piony czarne (0) i biale (1) kazdej gry; wolne miejsca maja puste plansze.
+	AlignedArray<uint64_t> pawns[2];
+	// Ruchy gracza, ruchy jeszcze nieocenione, oceniany ruch i przejmowane przez niego piony.
+	AlignedArray<uint64_t> valid;
+	AlignedArray<uint64_t> remaining;
+	AlignedArray<uint64_t> moves;
+	AlignedArray<uint64_t> flips;
+	// Ruchy o najlepszej ocenie i ta ocena.
+	AlignedArray<uint64_t> bestMoves;
+	AlignedArray<Board::EVALUATION_TYPE> bestValues;
+	AlignedArray<Board::EVALUATION_TYPE> values;
+	// Numer planszy gry (-1 - wolne miejsce) i czy w biezacej rundzie wykonano ruch.
+	AlignedArray<int> games;
+	AlignedArray<unsigned char> moved;
+	// Indeksy krotek sieci czarnych (0) i bialych (1) z perspektywy czarnych: [krotka * nLanes + gra].
+	AlignedArray<int> indexes[2];
+	// Zmiany indeksow krotek po ocenianym ruchu (poza ocena zerowe).
+	AlignedArray<int> deltas;
+	// Bity krotek kazdych WIDTH gier zmienionych przez oceniane ruchy ([gry / WIDTH * nWords + slowo]).
+	AlignedArray<uint64_t> touched;
+	int nWords;
+#ifdef __AVX2__
+	// Wagi krotek przed ruchem i bity krotek, dla ktorych wyznaczono je w tym kroku
+	// (uklad jak deltas i touched).
+	AlignedArray<Board::EVALUATION_TYPE> oldWeights;
+	AlignedArray<uint64_t> oldKnown;
+#endif // __AVX2__
+	// Generatory gier: czy ruch jest losowy, ruch losowy i wybor sposrod rownie dobrych ruchow gracza.
+	std::vector<Random<float> > moveRandom;
+	std::vector<Random<int> > choiceRandom;
+	std::vector<Random<int> > tieRandom[2];
+
+	template <typename T>
+	static void reserve(AlignedArray<T> &array, int size)
+	{
+		if (array.size() < size)
+			array.resize(size);
+	}
+
+	void allocate()
+	{
+		int maxTuples = std::max(players[0]->network->nTuples, players[1]->network->nTuples);
+		for (int c = 0; c < 2; c++)
+		{
+			reserve(pawns[c], nLanes);
+			reserve(indexes[c], players[c]->network->nTuples * nLanes);
+			tieRandom[c].resize(nLanes);
+		}
+		reserve(valid, nLanes);
+		reserve(remaining, nLanes);
+		reserve(moves, nLanes);
+		reserve(flips, nLanes);
+		reserve(bestMoves, nLanes);
+		reserve(bestValues, nLanes);
+		reserve(values, nLanes);
+		reserve(games, nLanes);
+		reserve(moved, nLanes);
+		// zmiany i bity krotek sa zerowe poza ocena ruchu, wiec zmiana ukladu ich nie psuje
+		reserve(deltas, maxTuples * nLanes);
+		nWords = (maxTuples + 63) / 64;
+		reserve(touched, nWords * nLanes / WIDTH);
+#ifdef __AVX2__
+		reserve(oldWeights, maxTuples * nLanes);
+		reserve(oldKnown, nWords * nLanes / WIDTH);
+#endif // __AVX2__
+		moveRandom.resize(nLanes);
+		choiceRandom.resize(nLanes);
+
+		for (int l = 0; l < nLanes; l++)
+		{
+			games[l] = -1;
+			pawns[0][l] = 0;
+			pawns[1][l] = 0;
+		}
+		// wagi przed ruchem pobierane sa dla wszystkich gier grupy, wiec indeksy miejsc
+		// bez gry musza lezec w tablicy wag biezacych sieci (pusta plansza)
+		for (int c = 0; c < 2; c++)
+		{
+			const NTupleNetwork *network = players[c]->network;
+			int *index = indexes[c].get();
+			for (int t = 0; t < network->nTuples; t++)
+				std::fill(index + t * nLanes, index + (t + 1) * nLanes, network->maxIndexes[t] / 2);
+		}
+	}
+
+	// Rozpoczyna w miejscu l gre od planszy b.
+	void startGame(int l, int b, BoardLoader *boards, unsigned seed)
+	{
+		Board board(boards->getBoardValues(b));
+		pawns[0][l] = board.getPawns(Board::BLACK);
+		pawns[1][l] = board.getPawns(Board::WHITE);
+		games[l] = b;
+
+		Rand random(seed + b);
+		moveRandom[l] = Random<float>(random.rand());
+		choiceRandom[l] = Random<int>(random.rand());
+		tieRandom[0][l] = Random<int>(random.rand());
+		tieRandom[1][l] = Random<int>(random.rand());
+
+		// indeksy pustej planszy, a nastepnie cyfry pionow (czarny +1, bialy -1)
+		for (int c = 0; c < 2; c++)
+		{
+			const NTupleNetwork *network = players[c]->network;
+			int *column = indexes[c].get() + l;
+			for (int t = 0; t < network->nTuples; t++)
+				column[t * nLanes] = network->maxIndexes[t] / 2;
+			for (int p = 0; p < 2; p++)
+			{
+				Board::BITBOARD_TYPE mask = pawns[p][l];
+				while (mask)
+				{
+					addDigits(network, column, Board::bitScanForward(mask), p == 0 ? 1 : -1);
+					mask &= mask - 1;
+				}
+			}
+		}
+	}
+
+	Board::EVALUATION_TYPE getResult(int l)
+	{
+		int black = Board::popCount(pawns[0][l]);
+		int white = Board::popCount(pawns[1][l]);
+		return black == white ? 0.5f : (black > white ? 1.0f : 0.0f);
+	}
+
+	// Wykonuje ruch gracza side (0 - czarne) w kazdej grze (jak Othello::playMove i CpuPlayer::chooseMove).
+	void step(int side)
+	{
+		const Player &player = *players[side];
+		Board::BOARD_ELEMENT_TYPE color = side == 0 ? Board::BLACK : Board::WHITE;
+		// negowany gracz ocenia plansze z perspektywy czarnych i neguje wynik
+		bool negated = side == 1 && player.negated;
+
+		const uint64_t *own = pawns[side].get();
+		const uint64_t *opp = pawns[1 - side].get();
+		for (int l = 0; l < nLanes; l += Masks::N)
+			Masks::store(valid.get() + l, getValidMoves(Masks::load(own + l), Masks::load(opp + l)));
+
+		int maxMoves = 0;
+		for (int l = 0; l < nLanes; l++)
+		{
+			remaining[l] = 0;
+			if (valid[l] == 0)
+				continue;
+			moved[l] = 1;
+			int n = Board::popCount(valid[l]);
+			if (player.randomMoveFreq > moveRandom[l].getValue())
+			{
+				bestMoves[l] = getNthBit(valid[l], choiceRandom[l].getValue(n));
+			}
+			else if (n == 1)
+			{
+				bestMoves[l] = valid[l];
+			}
+			else
+			{
+				remaining[l] = valid[l];
+				bestMoves[l] = 0;
+				bestValues[l] = Board::WORSE_EVAL;
+				maxMoves = std::max(maxMoves, n);
+			}
+		}
+
+		if (maxMoves > 0)
+		{
+			if (side == 1 && !negated)
+				evaluate<true>(side, color, negated, maxMoves);
+			else
+				evaluate<false>(side, color, negated, maxMoves);
+		}
+
+		for (int l = 0; l < nLanes; l++)
+		{
+			if (valid[l] == 0)
+				continue;
+			int n = Board::popCount(bestMoves[l]);
+			makeMove(l, side, n > 1 ? getNthBit(bestMoves[l], tieRandom[side][l].getValue(n)) : bestMoves[l]);
+		}
+	}
+
+	// Ocenia kolejno k-te ruchy z remaining wszystkich gier i zapamietuje najlepsze.
+	// WHITE_PERSPECTIVE - gracz ocenia plansze z perspektywy bialych.
+	template <bool WHITE_PERSPECTIVE>
+	void evaluate(int side, Board::BOARD_ELEMENT_TYPE color, bool negated, int maxMoves)
+	{
+		const uint64_t *own = pawns[side].get();
+		const uint64_t *opp = pawns[1 - side].get();
+#ifdef __AVX2__
+		memset(oldKnown.get(), 0, sizeof(uint64_t) * nWords * nLanes / WIDTH);
+#endif // __AVX2__
+		for (int k = 0; k < maxMoves; k++)
+		{
+			for (int l = 0; l < nLanes; l += Masks::N)
+			{
+				typename Masks::TYPE move = Masks::lowestBit(Masks::load(remaining.get() + l));
+				Masks::store(moves.get() + l, move);
+				// bez AVX2 pomijane sa gry bez ocenianego ruchu
+				if (Masks::N > 1 || remaining[l] != 0)
+					Masks::store(flips.get() + l, getFlips(move, Masks::load(own + l), Masks::load(opp + l)));
+			}
+			for (int l = 0; l < nLanes; l++)
+			{
+				if (moves[l] != 0)
+					addDeltas(side, l, moves[l], flips[l], color);
+			}
+
+			evaluateMoves<WHITE_PERSPECTIVE>(side);
+
+			for (int l = 0; l < nLanes; l++)
+			{
+				if (moves[l] == 0)
+					continue;
+				Board::EVALUATION_TYPE value = negated ? -values[l] : values[l];
+				if (value == bestValues[l] || std::abs(value - bestValues[l]) < EPS_VALUE)
+				{
+					bestMoves[l] |= moves[l];
+				}
+				else if (bestValues[l] < value || k == 0)
+				{
+					bestValues[l] = value;
+					bestMoves[l] = moves[l];
+				}
+				remaining[l] &= remaining[l] - 1;
+			}
+		}
+	}
+
+	// Zmiana oceny po ocenianym ruchu kazdej gry: values[gra] = suma zmian wag krotek
+	// o zmienionym indeksie w kolejnosci krotek, niezalezna od pozostalych ocenianych gier.
+	// Przechodzi tylko krotki zmienione w ktorejkolwiek z WIDTH gier i zeruje ich zmiany;
+	// wagi przed ruchem pobierane sa przy pierwszym uzyciu krotki w kroku.
+	template <bool WHITE_PERSPECTIVE>
+	void evaluateMoves(int side)
+	{
+		const NTupleNetwork *network = players[side]->network;
+		const Board::EVALUATION_TYPE *w = players[side]->weights;
+		const int *offsets = network->weightOffsets.get();
+		const int *maxIdx = network->maxIndexes.get();
+		const int *index = indexes[side].get();
+		int *delta = deltas.get();
+#ifdef __AVX2__
+		Board::EVALUATION_TYPE *old = oldWeights.get();
+#endif // __AVX2__
+		for (int g = 0; g < nLanes; g += WIDTH)
+		{
+			uint64_t *groupTouched = touched.get() + g / WIDTH * nWords;
+#ifdef __AVX2__
+			uint64_t *groupKnown = oldKnown.get() + g / WIDTH * nWords;
+			__m256 sum = _mm256_setzero_ps();
+#else
+			Board::EVALUATION_TYPE sum[WIDTH] = { 0 };
+#endif // __AVX2__
+			for (int word = 0; word < nWords; word++)
+			{
+				uint64_t bits = groupTouched[word];
+				groupTouched[word] = 0;
+#ifdef __AVX2__
+				uint64_t unknown = bits & ~groupKnown[word];
+				groupKnown[word] |= bits;
+#endif // __AVX2__
+				while (bits)
+				{
+					int t = 64 * word + Board::bitScanForward(bits);
+					int row = t * nLanes + g;
+					int base = offsets[t] + (WHITE_PERSPECTIVE ? maxIdx[t] : 0);
+#ifdef __AVX2__
+					__m256i baseVector = _mm256_set1_epi32(base);
+					__m256i i = _mm256_load_si256(reinterpret_cast<const __m256i *>(index + row));
+					if (unknown & bits & (0 - bits))
+					{
+						__m256i oldIndex = WHITE_PERSPECTIVE ? _mm256_sub_epi32(baseVector, i) : _mm256_add_epi32(baseVector, i);
+						_mm256_store_ps(old + row, _mm256_i32gather_ps(w, oldIndex, 4));
+					}
+					__m256i d = _mm256_load_si256(reinterpret_cast<const __m256i *>(delta + row));
+					__m256 changed = _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(d, _mm256_setzero_si256()), _mm256_set1_epi32(-1)));
+					i = _mm256_add_epi32(i, d);
+					i = WHITE_PERSPECTIVE ? _mm256_sub_epi32(baseVector, i) : _mm256_add_epi32(baseVector, i);
+					__m256 value = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), w, i, changed, 4);
+					sum = _mm256_add_ps(sum, _mm256_and_ps(_mm256_sub_ps(value, _mm256_load_ps(old + row)), changed));
+					_mm256_store_si256(reinterpret_cast<__m256i *>(delta + row), _mm256_setzero_si256());
+#else
+					// wagi przed ruchem pobierane sa od razu - wynik jest ten sam
+					for (int l = 0; l < WIDTH; l++)
+					{
+						int d = delta[row + l];
+						if (d == 0)
+							continue;
+						int i = index[row + l];
+						sum[l] += w[WHITE_PERSPECTIVE ? base - i - d : base + i + d] - w[WHITE_PERSPECTIVE ? base - i : base + i];
+						delta[row + l] = 0;
+					}
+#endif // __AVX2__
+					bits &= bits - 1;
+				}
+			}
+#ifdef __AVX2__
+			_mm256_store_ps(values.get() + g, sum);
+#else
+			for (int l = 0; l < WIDTH; l++)
+				values[g + l] = sum[l];
+#endif // __AVX2__
+		}
+	}
+
+	// Dodaje do deltas zmiany indeksow krotek sieci gracza side po ruchu move w grze l
+	// (jak DynamicNTuples::getValue) i zaznacza zmienione krotki w bitach grupy gry.
+	void addDeltas(int side, int l, uint64_t move, uint64_t flipped, Board::BOARD_ELEMENT_TYPE color)
+	{
+		const NTupleNetwork *network = players[side]->network;
+		int *column = deltas.get() + l;
+		uint64_t *groupTouched = touched.get() + l / WIDTH * nWords;
+		while (flipped)
+		{
+			addDigits(network, column, Board::bitScanForward(flipped), -2 * color, groupTouched);
+			flipped &= flipped - 1;
+		}
+		addDigits(network, column, Board::bitScanForward(move), -color, groupTouched);
+	}
+
+	// Wykonuje ruch move gracza side w grze l i uaktualnia indeksy krotek obu sieci.
+	void makeMove(int l, int side, uint64_t move)
+	{
+		Board::BOARD_ELEMENT_TYPE color = side == 0 ? Board::BLACK : Board::WHITE;
+		uint64_t flipped = getFlips<SingleMask>(move, pawns[side][l], pawns[1 - side][l]);
+		pawns[side][l] |= flipped | move;
+		pawns[1 - side][l] &= ~flipped;
+
+		for (int c = 0; c < 2; c++)
+		{
+			const NTupleNetwork *network = players[c]->network;
+			int *column = indexes[c].get() + l;
+			uint64_t mask = flipped;
+			while (mask)
+			{
+				addDigits(network, column, Board::bitScanForward(mask), -2 * color);
+				mask &= mask - 1;
+			}
+			addDigits(network, column, Board::bitScanForward(move), -color);
+		}
+	}
+
+	// Dodaje zmiane cyfry pola do indeksow zawierajacych je krotek w kolumnie gry
+	// i zaznacza te krotki w bitach groupTouched (nullptr - bez zaznaczania).
+	void addDigits(const NTupleNetwork *network, int *column, int bit, int digitDelta, uint64_t *groupTouched = nullptr)
+	{
+		const NTupleNetwork::TuplePower *tuplesInPos = network->tuplesInPos.get();
+		for (int j = network->posBegin[bit]; j < network->posBegin[bit + 1]; j++)
+		{
+			int t = tuplesInPos[j].tuple;
+			column[t * nLanes] += digitDelta * tuplesInPos[j].power;
+			if (groupTouched != nullptr)
+				groupTouched[t >> 6] |= (uint64_t)1 << (t & 63);
+		}
+	}
+
+	// Zwraca n-ty (od 0) ustawiony bit maski.
+	static uint64_t getNthBit(uint64_t mask, int n)
+	{
+		for (int i = 0; i < n; i++)
+			mask &= mask - 1;
+		return mask & (0 - mask);
+	}
+
+	// Ruchy i przejmowane piony jak w BitBoard (Kogge-Stone), dla masek typu M.
+	template <int S>
+	static uint64_t getShiftMask()
+	{
+		// bez kolumny A dla ruchu w prawo, bez kolumny H dla ruchu w lewo
+		return (S == 1 || S == -7 || S == 9) ? 0xfefefefefefefefeULL
+			: (S == -1 || S == 7 || S == -9) ? 0x7f7f7f7f7f7f7f7fULL
+			: 0xffffffffffffffffULL;
+	}
+
+	template <typename M, int S>
+	static typename M::TYPE shiftOne(typename M::TYPE value)
+	{
+		return M::bitAnd(M::template shift<S>(value), M::constant(getShiftMask<S>()));
+	}
+
+	template <typename M, int S>
+	static typename M::TYPE fill(typename M::TYPE gen, typename M::TYPE pro)
+	{
+		pro = M::bitAnd(pro, M::constant(getShiftMask<S>()));
+		gen = M::bitOr(gen, M::bitAnd(pro, M::template shift<S>(gen)));
+		pro = M::bitAnd(pro, M::template shift<S>(pro));
+		gen = M::bitOr(gen, M::bitAnd(pro, M::template shift<2 * S>(gen)));
+		pro = M::bitAnd(pro, M::template shift<2 * S>(pro));
+		return M::bitOr(gen, M::bitAnd(pro, M::template shift<4 * S>(gen)));
+	}
+
+	template <typename M, int S>
+	static typename M::TYPE movesDir(typename M::TYPE own, typename M::TYPE opp, typename M::TYPE empty)
+	{
+		return M::bitAnd(shiftOne<M, S>(M::bitAnd(fill<M, S>(own, opp), opp)), empty);
+	}
+
+	template <typename M, int S>
+	static typename M::TYPE flipsDir(typename M::TYPE move, typename M::TYPE own, typename M::TYPE opp)
+	{
+		typename M::TYPE line = M::bitAnd(fill<M, S>(move, opp), opp);
+		return M::ifNonZero(M::bitAnd(shiftOne<M, S>(line), own), line);
+	}
+
+	template <typename M = Masks>
+	static typename M::TYPE getValidMoves(typename M::TYPE own, typename M::TYPE opp)
+	{
+		typename M::TYPE empty = M::bitAndNot(M::constant(~0ULL), M::bitOr(own, opp));
+		return M::bitOr(M::bitOr(M::bitOr(movesDir<M, -9>(own, opp, empty), movesDir<M, -8>(own, opp, empty)),
+				M::bitOr(movesDir<M, -7>(own, opp, empty), movesDir<M, -1>(own, opp, empty))),
+			M::bitOr(M::bitOr(movesDir<M, 1>(own, opp, empty), movesDir<M, 7>(own, opp, empty)),
+				M::bitOr(movesDir<M, 8>(own, opp, empty), movesDir<M, 9>(own, opp, empty))));
+	}
+
+	template <typename M = Masks>
+	static typename M::TYPE getFlips(typename M::TYPE move, typename M::TYPE own, typename M::TYPE opp)
+	{
+		return M::bitOr(M::bitOr(M::bitOr(flipsDir<M, -9>(move, own, opp), flipsDir<M, -8>(move, own, opp)),
+				M::bitOr(flipsDir<M, -7>(move, own, opp), flipsDir<M, -1>(move, own, opp))),
+			M::bitOr(M::bitOr(flipsDir<M, 1>(move, own, opp), flipsDir<M, 7>(move, own, opp)),
+				M::bitOr(flipsDir<M, 8>(move, own, opp), flipsDir<M, 9>(move, own, opp))));
+	}
+};
+
+#endif //BATCHED_GAMES_H
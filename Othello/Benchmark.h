@@ -0,0 +1,363 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include "Watch.h"
+#include "Othello.h"
+#include "OthelloPlayer.h"
+#include "OptimizerConfiguration.h"
+#include "ThreadPool.h"
+#include "cma-es/cmaes.h"
+
+// Powtarzalne pomiary wydajnosci poszczegolnych warstw programu.
+// Kazdy pomiar wykonywany jest raz na rozgrzewke, a nastepnie nSamples razy.
+// Wyniki wypisywane sa po jednym obiekcie JSON w wierszu: srednia, odchylenie
+// standardowe i 95% przedzial ufnosci sredniej (rozklad t-Studenta).
+class Benchmark
+{
+public:
+	Benchmark(Configuration *conf, int seed, int nThreads, int nSamples, FILE *output = stdout) :
+		conf(conf), rand(seed), nThreads(nThreads < 1 ? 1 : nThreads), nSamples(nSamples < 2 ? 2 : nSamples), output(output)
+	{
+	}
+
+	void runAll()
+	{
+		collectPositions(2000);
+		benchValidMoves();
+		benchMakeMove();
+		benchSimulateMove();
+		benchPlayers();
+		int sizes[] = { 64, 1701, 8748 };
+		for (int i = 0; i < 3; i++)
+			benchCmaEs(sizes[i]);
+		benchGames();
+	}
+
+	// Zbiera pozycje z gier losowych rozpoczynanych z plansz konfiguracji.
+	void collectPositions(int maxPositions)
+	{
+		positions.clear();
+		colors.clear();
+		Random<int> r(rand.rand());
+		Board::MOVES_TYPE moves;
+		BoardLoader *boards = conf->getBoards();
+		for (int b = 0; (int)positions.size() < maxPositions; b = (b + 1) % boards->getNBoards())
+		{
+			Board board(boards->getBoardValues(b));
+			Board::BOARD_ELEMENT_TYPE player = Board::BLACK;
+			int passes = 0;
+			while (passes < 2 && (int)positions.size() < maxPositions)
+			{
+				board.validMoves(moves, player);
+				if (moves.size() == 0)
+				{
+					passes++;
+				}
+				else
+				{
+					passes = 0;
+					positions.push_back(board);
+					colors.push_back(player);
+					int m = r.getValue(moves.size());
+					board.makeMove(moves[m], moves.getFlips(m), player);
+				}
+				player = -player;
+			}
+		}
+	}
+
+	void benchValidMoves()
+	{
+		Board::MOVES_TYPE moves;
+		int total = 0;
+		measure("board.validMoves", "ns/op", (double)positions.size(), [&]()
+		{
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				positions[i].validMoves(moves, colors[i]);
+				total += moves.size();
+			}
+		});
+		sink += total;
+	}
+
+	void benchMakeMove()
+	{
+		std::vector<Board::MOVES_TYPE> allMoves = getAllMoves();
+		measure("board.makeMove+undoMove", "ns/op", (double)countMoves(allMoves), [&]()
+		{
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				Board &board = positions[i];
+				for (int m = 0; m < allMoves[i].size(); m++)
+				{
+					board.makeMove(allMoves[i][m], allMoves[i].getFlips(m), colors[i]);
+					sink += board.getNPawns();
+					board.undoMove(allMoves[i][m], allMoves[i].getFlips(m), colors[i]);
+				}
+			}
+		});
+	}
+
+	void benchSimulateMove()
+	{
+		std::vector<Board::MOVES_TYPE> allMoves = getAllMoves();
+		GameData data;
+		measure("board.simulateMove", "ns/op", (double)countMoves(allMoves), [&]()
+		{
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				for (int m = 0; m < allMoves[i].size(); m++)
+				{
+					positions[i].simulateMove(&data.positions, allMoves[i][m], colors[i]);
+					sink += data.positions.size();
+				}
+			}
+		});
+	}
+
+	// Ocena ruchow (getMove) przez kazdego gracza konfiguracji, w przeliczeniu na oceniany ruch.
+	// Pozycje pochodza z gier rozegranych przez gracza i oceniane sa w kolejnosci gry,
+	// wiec gracze sieci krotek uaktualniaja indeksy przyrostowo, jak podczas gry.
+	void benchPlayers()
+	{
+		GameData data;
+		for (int p = 0; p < conf->getNPlayers(); p++)
+		{
+			OthelloPlayer *player = conf->getPlayerLoader(p)->getPlayer(rand.rand(), false);
+			if (player == nullptr)
+				continue;
+			PlayerParams *params = player->getPlayerParams(rand.rand());
+			std::vector<Board> gamePositions;
+			std::vector<Board::BOARD_ELEMENT_TYPE> gameColors;
+			std::vector<Board::MOVES_TYPE> gameMoves;
+			collectGamePositions(player, params, (int)positions.size(), gamePositions, gameColors, gameMoves);
+			std::string name = "evaluate." + getShortName(p);
+			measure(name.c_str(), "ns/move", (double)countMoves(gameMoves), [&]()
+			{
+				for (size_t i = 0; i < gamePositions.size(); i++)
+					sink += player->getMove(&gamePositions[i], &gameMoves[i], gameColors[i], false, params, &data);
+			});
+			delete params;
+			delete player;
+		}
+	}
+
+	// Losowanie populacji i aktualizacja rozkladu CMA-ES dla N wag.
+	void benchCmaEs(int nWeights)
+	{
+		const int N_GENERATIONS = 5;
+		CMAES<Board::EVALUATION_TYPE> cmaes(rand.rand());
+		std::vector<Board::EVALUATION_TYPE> weights(nWeights, 0), stddev(nWeights, 1);
+		Parameters<Board::EVALUATION_TYPE> parameters;
+		parameters.init(nWeights, weights.data(), stddev.data());
+		Board::EVALUATION_TYPE *fitness = cmaes.init(parameters);
+		int lambda = (int)cmaes.get(CMAES<Board::EVALUATION_TYPE>::Lambda);
+		Random<Board::EVALUATION_TYPE> r(rand.rand());
+
+		std::vector<double> sampleTimes, updateTimes;
+		for (int s = 0; s <= nSamples; s++)
+		{
+			double sampleTime = 0, updateTime = 0;
+			for (int g = 0; g < N_GENERATIONS; g++)
+			{
+				Watch<double> watch;
+				cmaes.samplePopulation();
+				sampleTime += watch.stop();
+				for (int i = 0; i < lambda; i++)
+					fitness[i] = r.getValue();
+				watch.start();
+				cmaes.updateDistribution(fitness);
+				updateTime += watch.stop();
+			}
+			// pierwsza seria jest rozgrzewka
+			if (s > 0)
+			{
+				sampleTimes.push_back(1e9 * sampleTime / N_GENERATIONS);
+				updateTimes.push_back(1e9 * updateTime / N_GENERATIONS);
+			}
+		}
+
+		char name[64];
+		sprintf(name, "cmaes.samplePopulation.N%d", nWeights);
+		report(name, "ns/generation", sampleTimes);
+		sprintf(name, "cmaes.updateDistribution.N%d", nWeights);
+		report(name, "ns/generation", updateTimes);
+	}
+
+	// Pelne gry gracza 0 z pozostalymi graczami na planszach konfiguracji,
+	// w jednym watku i na nThreads watkach puli.
+	void benchGames()
+	{
+		int nPlayers = conf->getNPlayers();
+		int nBoards = conf->getBoards()->getNBoards();
+		if (nPlayers < 2)
+			return;
+
+		OthelloPlayer **players = new OthelloPlayer*[nPlayers];
+		for (int i = 0; i < nPlayers; i++)
+			players[i] = conf->getPlayerLoader(i)->getPlayer(rand.rand(), conf->getPlayerNeg(i));
+
+		std::vector<Othello *> othellos;
+		for (int i = 0; i < nThreads; i++)
+			othellos.push_back(new Othello(players, nPlayers, rand.rand()));
+
+		double games = 2.0 * (nPlayers - 1) * nBoards;
+		for (int threads = 1; ; threads = nThreads)
+		{
+			std::vector<double> samples;
+			for (int s = 0; s <= nSamples; s++)
+			{
+				Watch<double> watch;
+				ThreadPool::getPool(threads).run(threads, [&](int t)
+				{
+					for (int b = t; b < nBoards; b += threads)
+					{
+						Board board(conf->getBoards()->getBoardValues(b));
+						for (int e = 1; e < nPlayers; e++)
+							sink += othellos[t]->playDouble(&board, 0, e).item1;
+					}
+				});
+				double time = watch.stop();
+				if (s > 0)
+					samples.push_back(games / time);
+			}
+			char name[64];
+			sprintf(name, "games.threads%d", threads);
+			report(name, "games/s", samples);
+			if (threads == nThreads)
+				break;
+		}
+
+		for (int i = 0; i < nThreads; i++)
+			delete othellos[i];
+		for (int i = 0; i < nPlayers; i++)
+			delete players[i];
+		delete[] players;
+	}
+
+	// Wypisuje wynik pomiaru. samples - wartosci poszczegolnych powtorzen.
+	void report(const char *name, const char *unit, const std::vector<double> &samples)
+	{
+		int n = (int)samples.size();
+		double mean = 0;
+		for (int i = 0; i < n; i++)
+			mean += samples[i];
+		mean /= n;
+		double variance = 0;
+		for (int i = 0; i < n; i++)
+			variance += (samples[i] - mean) * (samples[i] - mean);
+		double stddev = n > 1 ? sqrt(variance / (n - 1)) : 0;
+		double halfWidth = getStudentT(n - 1) * stddev / sqrt((double)n);
+
+		fprintf(output, "{\"benchmark\": \"%s\", \"unit\": \"%s\", \"samples\": %d, \"mean\": %.6g, \"stddev\": %.6g, \"ci95_low\": %.6g, \"ci95_high\": %.6g}\n",
+			name, unit, n, mean, stddev, mean - halfWidth, mean + halfWidth);
+		fflush(output);
+	}
+
+	// Zapobiega usunieciu mierzonych obliczen przez kompilator.
+	double getSink()
+	{
+		return sink;
+	}
+private:
+	Configuration *conf;
+	Rand rand;
+	int nThreads;
+	int nSamples;
+	FILE *output;
+	std::vector<Board> positions;
+	std::vector<Board::BOARD_ELEMENT_TYPE> colors;
+	double sink = 0;
+
+	// Mierzy czas operacji body w nanosekundach na jedna z nOps operacji.
+	void measure(const char *name, const char *unit, double nOps, const std::function<void()> &body)
+	{
+		std::vector<double> samples;
+		body();
+		for (int s = 0; s < nSamples; s++)
+		{
+			Watch<double> watch;
+			body();
+			samples.push_back(1e9 * watch.stop() / (nOps > 0 ? nOps : 1));
+		}
+		report(name, unit, samples);
+	}
+
+	// Zbiera kolejne pozycje (z ruchem do wykonania) gier rozgrywanych przez gracza
+	// z samym soba od plansz konfiguracji.
+	void collectGamePositions(OthelloPlayer *player, PlayerParams *params, int maxPositions, std::vector<Board> &gamePositions,
+		std::vector<Board::BOARD_ELEMENT_TYPE> &gameColors, std::vector<Board::MOVES_TYPE> &gameMoves)
+	{
+		GameData data;
+		Board::MOVES_TYPE moves;
+		BoardLoader *boards = conf->getBoards();
+		for (int b = 0; (int)gamePositions.size() < maxPositions; b = (b + 1) % boards->getNBoards())
+		{
+			Board board(boards->getBoardValues(b));
+			Board::BOARD_ELEMENT_TYPE color = Board::BLACK;
+			int passes = 0;
+			while (passes < 2 && (int)gamePositions.size() < maxPositions)
+			{
+				board.validMoves(moves, color);
+				if (moves.size() == 0)
+				{
+					passes++;
+				}
+				else
+				{
+					passes = 0;
+					gamePositions.push_back(board);
+					gameColors.push_back(color);
+					gameMoves.push_back(moves);
+					Board::INDEX_TYPE move = player->getMove(&board, &moves, color, false, params, &data);
+					board.makeMove(move, moves.getFlips(moves.find(move)), color);
+				}
+				color = -color;
+			}
+		}
+	}
+
+	std::vector<Board::MOVES_TYPE> getAllMoves()
+	{
+		std::vector<Board::MOVES_TYPE> allMoves(positions.size());
+		for (size_t i = 0; i < positions.size(); i++)
+			positions[i].validMoves(allMoves[i], colors[i]);
+		return allMoves;
+	}
+
+	static long long countMoves(const std::vector<Board::MOVES_TYPE> &allMoves)
+	{
+		long long n = 0;
+		for (size_t i = 0; i < allMoves.size(); i++)
+			n += allMoves[i].size();
+		return n;
+	}
+
+	std::string getShortName(int player)
+	{
+		std::string s(conf->getPlayerName(player));
+		s = s.substr(s.find_last_of('/') + 1);
+		return s.substr(0, s.find_last_of('.'));
+	}
+
+	// Kwantyl 0.975 rozkladu t-Studenta dla df stopni swobody.
+	static double getStudentT(int df)
+	{
+		static const double T[] = { 0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		if (df < 1)
+			return 0;
+		if (df <= 30)
+			return T[df];
+		return 1.96;
+	}
+};
+
+#endif //BENCHMARK_H
@@ -0,0 +1,623 @@
+#ifndef BIT_BOARD_H
+#define BIT_BOARD_H
+
+#include "Header.h"
+#include <iostream>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "SparseSet.h"
+#include "Vector.h"
+#include "Tuple.h"
+#include "MoveList.h"
+#include "Zobrist.h"
+#include <assert.h>
+
+#include <limits.h>
+#include <float.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Tablica przejscia z indeksu pola planszy 10x10 na numer bitu w masce (-1 dla scian).
+template <typename T>
+struct BitBoardTables
+{
+	static const T BIT_INDEX[100];
+};
+
+template <typename T>
+const T BitBoardTables<T>::BIT_INDEX[100] =
+{
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7, -1,
+	-1,  8,  9, 10, 11, 12, 13, 14, 15, -1,
+	-1, 16, 17, 18, 19, 20, 21, 22, 23, -1,
+	-1, 24, 25, 26, 27, 28, 29, 30, 31, -1,
+	-1, 32, 33, 34, 35, 36, 37, 38, 39, -1,
+	-1, 40, 41, 42, 43, 44, 45, 46, 47, -1,
+	-1, 48, 49, 50, 51, 52, 53, 54, 55, -1,
+	-1, 56, 57, 58, 59, 60, 61, 62, 63, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// Plansza przechowywana w postaci dwoch 64-bitowych masek (piony czarne i biale).
+// Ruchy i przejmowane piony wyznaczane sa rownolegle dla calej planszy (Kogge-Stone).
+// Interfejs zgodny z MailboxBoard - indeksy pol sa nadal indeksami planszy 10x10.
+class BitBoard
+{
+public:
+	// Typ zwracany przez funkcje oceny stanu
+	typedef float EVALUATION_TYPE;
+
+	const static int WORSE_EVAL = INT_MIN;
+	const static int MAX_WEIGHT_VALUE = 1000000;
+	// Typ pojedynczego pola planszy.
+	typedef char BOARD_ELEMENT_TYPE;
+	// Typ indeksu pola.
+	typedef char INDEX_TYPE;
+	// Typ maski bitowej planszy.
+	typedef uint64_t BITBOARD_TYPE;
+	// Typ skrotu (Zobrista) pozycji.
+	typedef uint64_t HASH_TYPE;
+	// Maksymalna liczba mozliwych do wykonania ruchow.
+	const static int MAX_CH_POS = 62;
+	// Lista poprawnych ruchow wraz z przejmowanymi pionami.
+	typedef MoveList<INDEX_TYPE, BITBOARD_TYPE, MAX_CH_POS> MOVES_TYPE;
+	// Rozmiar planszy.
+	const static int SIZE = 100;
+	// Liczba mozliwych kierunkow ruchu.
+	const static int N_DIR = 8;
+	// Szerokosc/wysokosc planszy.
+	const static int WIDTH = 10;
+
+	// Wartosc oznaczjaca czarny pion.
+	const static BOARD_ELEMENT_TYPE BLACK = -1;
+	// Wartosc oznaczjaca bialy pion.
+	const static BOARD_ELEMENT_TYPE WHITE = 1;
+	// Wartosc oznaczjaca puste pole.
+	const static BOARD_ELEMENT_TYPE EMPTY = 0;
+	// Wartosc oznaczjaca sciane.
+	const static BOARD_ELEMENT_TYPE WALL = 2;
+
+	// Tworzy nowa plansze z poczatkowym ustawieniem pionow.
+	DEF BitBoard()
+	{
+		empty();
+	}
+
+	DEF BitBoard(const BitBoard &board)
+	{
+		copy(&board);
+	}
+
+	DEF BitBoard(BOARD_ELEMENT_TYPE *values)
+	{
+		setValues(values);
+	}
+
+	DEF void empty()
+	{
+		pawns[getColorIndex(BLACK)] = getBit(4, 5) | getBit(5, 4);
+		pawns[getColorIndex(WHITE)] = getBit(4, 4) | getBit(5, 5);
+
+		nPawns = 4;
+		hash = computeHash();
+	}
+
+	DEF void setValues(BOARD_ELEMENT_TYPE *values)
+	{
+		pawns[0] = pawns[1] = 0;
+
+		for (int i = 0; i < 64; i++)
+		{
+			if (values[i] == BLACK || values[i] == WHITE)
+				pawns[getColorIndex(values[i])] |= (BITBOARD_TYPE)1 << i;
+		}
+
+		this->nPawns = popCount(pawns[0] | pawns[1]);
+		hash = computeHash();
+	}
+
+	DEF void copy(const BitBoard *board)
+	{
+		memcpy(this, board, sizeof(BitBoard));
+	}
+
+	// Zwraca element na planszy znajdujacy sie na wskazanej pozycji.
+	DEF BOARD_ELEMENT_TYPE getValue(int x, int y)
+	{
+		return getValue(getIndex(x, y));
+	}
+
+	// Zwraca element na planszy znajdujacy sie pod wskazanym indeksem.
+	DEF BOARD_ELEMENT_TYPE getValue(INDEX_TYPE index)
+	{
+		int bit = getBitIndex(index);
+		if (bit < 0)
+			return WALL;
+
+		return (BOARD_ELEMENT_TYPE)(((pawns[1] >> bit) & 1) - ((pawns[0] >> bit) & 1));
+	}
+
+	// Ustawia wartosc elementu na planszy znajdujacego sie na wskazanej pozycji.
+	DEF void setValue(int x, int y, BOARD_ELEMENT_TYPE value)
+	{
+		setValue(getIndex(x, y), value);
+	}
+
+	// Ustawia wartosc elementu na planszy znajdujacego sie pod wskazanym indeksem.
+	DEF void setValue(INDEX_TYPE index, BOARD_ELEMENT_TYPE value)
+	{
+		if (getBitIndex(index) < 0)
+			return;
+
+		int bitIndex = getBitIndex(index);
+		BITBOARD_TYPE bit = getBit(index);
+		for (int c = 0; c < 2; c++)
+		{
+			if (pawns[c] & bit)
+				hash ^= ZobristTables<HASH_TYPE>::KEYS[c][bitIndex];
+			pawns[c] &= ~bit;
+		}
+		if (value == BLACK || value == WHITE)
+		{
+			pawns[getColorIndex(value)] |= bit;
+			hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(value)][bitIndex];
+		}
+	}
+
+	// Zwraca indeks odpowiadajacy wskazanej pozycji.
+	DEF static INDEX_TYPE getIndex(INDEX_TYPE x, INDEX_TYPE y)
+	{
+		return y * WIDTH + x;
+	}
+
+	// Zwraca wspolrzedna X pola.
+	DEF static INDEX_TYPE getX(INDEX_TYPE move)
+	{
+		return move % WIDTH;
+	}
+
+	// Zwraca wspolrzedna Y pola.
+	DEF static INDEX_TYPE getY(INDEX_TYPE move)
+	{
+		return move / WIDTH;
+	}
+
+	DEF static void getMoveX(INDEX_TYPE move, INDEX_TYPE *x)
+	{
+		*x = move % WIDTH;
+		if (*x > 1)
+			*x -= WIDTH;
+		else if (*x < -1)
+			*x += WIDTH;
+	}
+
+	DEF static void getMoveXY(INDEX_TYPE move, INDEX_TYPE *x, INDEX_TYPE *y)
+	{
+		getMoveX(move, x);
+		*y = (move - *x) / WIDTH;
+	}
+
+	// Zamienia indeks pola na numer bitu w masce (-1 dla scian).
+	DEF static int getBitIndex(INDEX_TYPE index)
+	{
+		return BitBoardTables<signed char>::BIT_INDEX[(int)index];
+	}
+
+	// Zamienia numer bitu w masce na indeks pola.
+	DEF static INDEX_TYPE getFieldIndex(int bitIndex)
+	{
+		return getIndex((bitIndex & 7) + 1, (bitIndex >> 3) + 1);
+	}
+
+	DEF static BITBOARD_TYPE getBit(INDEX_TYPE index)
+	{
+		return (BITBOARD_TYPE)1 << getBitIndex(index);
+	}
+
+	DEF static BITBOARD_TYPE getBit(int x, int y)
+	{
+		return getBit(getIndex(x, y));
+	}
+
+	// Okresla, czy na podanym polu jest mozliwy ruch.
+	DEF static bool isPlayable(int move)
+	{
+		int x = getX(move);
+		int y = getY(move);
+		if (x < 1 || x >= (WIDTH - 1))
+			return false;
+
+		if (y < 1 || y >= (WIDTH - 1))
+			return false;
+
+		return true;
+	}
+
+	// Umieszcza na liscie poprawne w danej chwili ruchy (w kolejnosci indeksow pol)
+	// razem z maskami pionow, ktore kazdy z nich przejmuje.
+	DEF void validMoves(MOVES_TYPE &moves, BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE own = pawns[getColorIndex(player)];
+		BITBOARD_TYPE opp = pawns[getColorIndex(-player)];
+		BITBOARD_TYPE valid = getValidMoves(player);
+
+		moves.clear();
+		while (valid)
+		{
+			int bit = bitScanForward(valid);
+			moves.add(getFieldIndex(bit), getFlips((BITBOARD_TYPE)1 << bit, own, opp));
+			valid &= valid - 1;
+		}
+	}
+
+	// Zwraca maske wszystkich poprawnych ruchow gracza.
+	DEF BITBOARD_TYPE getValidMoves(BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE own = pawns[getColorIndex(player)];
+		BITBOARD_TYPE opp = pawns[getColorIndex(-player)];
+		BITBOARD_TYPE empty = ~(own | opp);
+
+		return movesDir<-9>(own, opp, empty)
+			| movesDir<-8>(own, opp, empty)
+			| movesDir<-7>(own, opp, empty)
+			| movesDir<-1>(own, opp, empty)
+			| movesDir<1>(own, opp, empty)
+			| movesDir<7>(own, opp, empty)
+			| movesDir<8>(own, opp, empty)
+			| movesDir<9>(own, opp, empty);
+	}
+
+	// Zwraca maske pionow przejmowanych przez gracza po wykonaniu ruchu.
+	DEF BITBOARD_TYPE getFlips(INDEX_TYPE index, BOARD_ELEMENT_TYPE player)
+	{
+		return getFlips(getBit(index), pawns[getColorIndex(player)], pawns[getColorIndex(-player)]);
+	}
+
+	DEF static BITBOARD_TYPE getFlips(BITBOARD_TYPE move, BITBOARD_TYPE own, BITBOARD_TYPE opp)
+	{
+		return flipsDir<-9>(move, own, opp)
+			| flipsDir<-8>(move, own, opp)
+			| flipsDir<-7>(move, own, opp)
+			| flipsDir<-1>(move, own, opp)
+			| flipsDir<1>(move, own, opp)
+			| flipsDir<7>(move, own, opp)
+			| flipsDir<8>(move, own, opp)
+			| flipsDir<9>(move, own, opp);
+	}
+
+	// Uzupelnia kolekcje mozliwymi kierunkami.
+	DEF static void getDirections(Vector<INDEX_TYPE, N_DIR> &dir)
+	{
+		dir.clear();
+		dir.add(-WIDTH - 1);
+		dir.add(-WIDTH);
+		dir.add(-WIDTH + 1);
+		dir.add(-1);
+		dir.add(1);
+		dir.add(WIDTH - 1);
+		dir.add(WIDTH);
+		dir.add(WIDTH + 1);
+	}
+
+	// Wykonuje ruch umieszczajac na planszy pod wskazanym indeksem pion aktualnego gracza.
+	DEF void makeMove(INDEX_TYPE index, BOARD_ELEMENT_TYPE player)
+	{
+		makeMove(index, getFlips(index, player), player);
+	}
+
+	// Wykonuje ruch, ktorego przejmowane piony zostaly juz wyznaczone przez validMoves.
+	DEF void makeMove(INDEX_TYPE index, BITBOARD_TYPE flips, BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE changed = flips | getBit(index);
+		pawns[getColorIndex(player)] |= changed;
+		pawns[getColorIndex(-player)] &= ~changed;
+
+		hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(player)][getBitIndex(index)] ^ getFlipsHash(flips);
+		nPawns++;
+	}
+
+	// Cofa ruch wykonany przez makeMove(index, flips, player).
+	DEF void undoMove(INDEX_TYPE index, BITBOARD_TYPE flips, BOARD_ELEMENT_TYPE player)
+	{
+		pawns[getColorIndex(player)] &= ~(flips | getBit(index));
+		pawns[getColorIndex(-player)] |= flips;
+
+		hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(player)][getBitIndex(index)] ^ getFlipsHash(flips);
+		nPawns--;
+	}
+
+	// Wykonuje ruch umieszczajac na planszy pod wskazanym indeksem pion aktualnego gracza.
+	// positions - indeksy pol, na ktorych pojawiaja sie piony gracza
+	template <typename T>
+	DEF void makeMovePos(const T *positions, BOARD_ELEMENT_TYPE player)
+	{
+		performMove(positions, player);
+
+		nPawns++;
+	}
+
+	// Wypelnia kolekcje indeksami pol, na ktorych pojawia sie piony gracza po wykonaniu wskazanego ruchu.
+	// Kolejnosc pol jest taka sama jak w MailboxBoard (kierunki wg getDirections, od najdalszego pola).
+	template <typename T>
+	DEF void simulateMove(T *positions, INDEX_TYPE index, BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE move = getBit(index);
+		BITBOARD_TYPE own = pawns[getColorIndex(player)];
+		BITBOARD_TYPE opp = pawns[getColorIndex(-player)];
+
+		positions->clear();
+		addForward(positions, flipsDir<-9>(move, own, opp));
+		addForward(positions, flipsDir<-8>(move, own, opp));
+		addForward(positions, flipsDir<-7>(move, own, opp));
+		addForward(positions, flipsDir<-1>(move, own, opp));
+		addReverse(positions, flipsDir<1>(move, own, opp));
+		addReverse(positions, flipsDir<7>(move, own, opp));
+		addReverse(positions, flipsDir<8>(move, own, opp));
+		addReverse(positions, flipsDir<9>(move, own, opp));
+
+		positions->add(index);
+	}
+
+	// Wypelnia kolekcje indeksami pol, na ktorych pojawia sie piony gracza,
+	// na podstawie maski przejmowanych pionow zwroconej przez validMoves.
+	template <typename T>
+	DEF static void getPositions(T *positions, INDEX_TYPE index, BITBOARD_TYPE flips)
+	{
+		positions->clear();
+		addForward(positions, flips);
+		positions->add(index);
+	}
+
+	// Drukuje plansze w konsoli.
+	DEF void print()
+	{
+		printf("\n  ");
+		for(int x = 0; x < 10; x++)
+		{
+			printf(" %d ", x);
+		}
+		printf("\n");
+
+		for(int y = 0; y < 10; y++)
+		{
+			printf("\n%d ", y);
+			for(int x = 0; x < 10; x++)
+			{
+				printf(" %s ", getChar(getValue(x, y)));
+			}
+			printf("\n");
+		}
+		printf("\n");
+	}
+
+	DEF Tuple<int, int> counts()
+	{
+		return Tuple<int, int>(popCount(pawns[getColorIndex(BLACK)]), popCount(pawns[getColorIndex(WHITE)]));
+	}
+
+	// Zwraca rezultat rozgrywki w postaci ilosci pionow obu graczy.
+	DEF Tuple<EVALUATION_TYPE, EVALUATION_TYPE> result()
+	{
+		int count1 = popCount(pawns[getColorIndex(BLACK)]);
+		int count2 = popCount(pawns[getColorIndex(WHITE)]);
+
+		EVALUATION_TYPE result1 = 0;
+		EVALUATION_TYPE result2 = 0;
+		if (count1 == count2)
+			result1 = result2 = 0.5;
+		else if (count1 > count2)
+			result1 = 1;
+		else
+			result2 = 1;
+
+		return Tuple<EVALUATION_TYPE, EVALUATION_TYPE>(result1, result2);
+	}
+
+	// Wykonuje wskazany ruch poprzez umieszczenie pionow gracza na planszy.
+	template <typename T>
+	DEF void performMove(const T *positions, BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE changed = 0;
+		for(int i = 0; i < positions->size(); i++)
+		{
+			changed |= getBit(positions[0][i]);
+		}
+		BITBOARD_TYPE flips = changed & pawns[getColorIndex(-player)];
+		BITBOARD_TYPE placed = changed & ~(pawns[0] | pawns[1]);
+		pawns[getColorIndex(player)] |= changed;
+		pawns[getColorIndex(-player)] &= ~changed;
+
+		hash ^= getFlipsHash(flips);
+		while (placed)
+		{
+			hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(player)][bitScanForward(placed)];
+			placed &= placed - 1;
+		}
+	}
+
+	DEF int getNPawns()
+	{
+		return nPawns;
+	}
+
+	// Zwraca skrot Zobrista pozycji z uwzglednieniem gracza wykonujacego ruch.
+	DEF HASH_TYPE getHash(BOARD_ELEMENT_TYPE player)
+	{
+		return player == WHITE ? hash ^ ZobristTables<HASH_TYPE>::SIDE : hash;
+	}
+
+	// Wyznacza skrot pionow od nowa (musi byc rowny getHash(BLACK)).
+	DEF HASH_TYPE computeHash()
+	{
+		HASH_TYPE result = 0;
+		for (int c = 0; c < 2; c++)
+		{
+			BITBOARD_TYPE mask = pawns[c];
+			while (mask)
+			{
+				result ^= ZobristTables<HASH_TYPE>::KEYS[c][bitScanForward(mask)];
+				mask &= mask - 1;
+			}
+		}
+		return result;
+	}
+
+	// Zwraca maske pionow gracza o wskazanym kolorze.
+	DEF BITBOARD_TYPE getPawns(BOARD_ELEMENT_TYPE player)
+	{
+		return pawns[getColorIndex(player)];
+	}
+
+	DEF static int popCount(BITBOARD_TYPE value)
+	{
+#if defined(_MSC_VER)
+		return (int)__popcnt64(value);
+#else
+		return __builtin_popcountll(value);
+#endif
+	}
+
+	// Zwraca numer najmlodszego ustawionego bitu (value != 0).
+	DEF static int bitScanForward(BITBOARD_TYPE value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (int)index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	// Zwraca numer najstarszego ustawionego bitu (value != 0).
+	DEF static int bitScanReverse(BITBOARD_TYPE value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (int)index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+private:
+	// Piony czarne (0) i biale (1).
+	BITBOARD_TYPE pawns[2];
+	// Liczba pionow na planszy.
+	int nPawns;
+	// Skrot Zobrista pionow, uaktualniany przy kazdej zmianie planszy.
+	HASH_TYPE hash;
+
+	DEF static int getColorIndex(BOARD_ELEMENT_TYPE player)
+	{
+		return (player + 1) >> 1;
+	}
+
+	// Zmiana skrotu po zmianie koloru pionow z maski (klucze obu kolorow).
+	DEF static HASH_TYPE getFlipsHash(BITBOARD_TYPE flips)
+	{
+		HASH_TYPE result = 0;
+		while (flips)
+		{
+			int bit = bitScanForward(flips);
+			result ^= ZobristTables<HASH_TYPE>::KEYS[0][bit] ^ ZobristTables<HASH_TYPE>::KEYS[1][bit];
+			flips &= flips - 1;
+		}
+		return result;
+	}
+
+	// Przesuniecie maski o S bitow bez maskowania brzegow.
+	template <int S>
+	DEF static BITBOARD_TYPE shift(BITBOARD_TYPE value)
+	{
+		return S > 0 ? value << (S > 0 ? S : 0) : value >> (S > 0 ? 0 : -S);
+	}
+
+	// Maska pol, na ktore moze trafic pion przesuniety o S bez przejscia przez brzeg planszy.
+	template <int S>
+	DEF static BITBOARD_TYPE getShiftMask()
+	{
+		// bez kolumny A dla ruchu w prawo, bez kolumny H dla ruchu w lewo
+		return (S == 1 || S == -7 || S == 9) ? 0xfefefefefefefefeULL
+			: (S == -1 || S == 7 || S == -9) ? 0x7f7f7f7f7f7f7f7fULL
+			: 0xffffffffffffffffULL;
+	}
+
+	template <int S>
+	DEF static BITBOARD_TYPE shiftOne(BITBOARD_TYPE value)
+	{
+		return shift<S>(value) & getShiftMask<S>();
+	}
+
+	// Wypelnienie Kogge-Stone: rozszerza gen w kierunku S po polach z pro.
+	template <int S>
+	DEF static BITBOARD_TYPE fill(BITBOARD_TYPE gen, BITBOARD_TYPE pro)
+	{
+		pro &= getShiftMask<S>();
+		gen |= pro & shift<S>(gen);
+		pro &= shift<S>(pro);
+		gen |= pro & shift<2 * S>(gen);
+		pro &= shift<2 * S>(pro);
+		gen |= pro & shift<4 * S>(gen);
+		return gen;
+	}
+
+	template <int S>
+	DEF static BITBOARD_TYPE movesDir(BITBOARD_TYPE own, BITBOARD_TYPE opp, BITBOARD_TYPE empty)
+	{
+		return shiftOne<S>(fill<S>(own, opp) & opp) & empty;
+	}
+
+	template <int S>
+	DEF static BITBOARD_TYPE flipsDir(BITBOARD_TYPE move, BITBOARD_TYPE own, BITBOARD_TYPE opp)
+	{
+		BITBOARD_TYPE line = fill<S>(move, opp) & opp;
+		return (shiftOne<S>(line) & own) ? line : 0;
+	}
+
+	template <typename T>
+	DEF static void addForward(T *positions, BITBOARD_TYPE mask)
+	{
+		while (mask)
+		{
+			positions->add(getFieldIndex(bitScanForward(mask)));
+			mask &= mask - 1;
+		}
+	}
+
+	template <typename T>
+	DEF static void addReverse(T *positions, BITBOARD_TYPE mask)
+	{
+		while (mask)
+		{
+			int bit = bitScanReverse(mask);
+			positions->add(getFieldIndex(bit));
+			mask ^= (BITBOARD_TYPE)1 << bit;
+		}
+	}
+
+	DEF const char * getChar(BOARD_ELEMENT_TYPE value)
+	{
+		switch (value)
+		{
+		case WHITE:
+			return "X";
+		case BLACK:
+			return "O";
+		case WALL:
+		case -WALL:
+			return "+";
+		case EMPTY:
+			return " ";
+		default:
+			return "?";
+		}
+	}
+};
+
+#endif //BIT_BOARD_H
@@ -51,7 +51,11 @@ class AbsCmaEsOptimizer : public WeightsOptimizer
 		if (createCmaesLevel() == 0)
 			createCmaes(bestWeights, currentConfiguration->getPlayerLoader(0)->getNWeights());
 
-		Board::EVALUATION_TYPE *const*pop = cmaes->samplePopulation();
+		Board::EVALUATION_TYPE *const*pop;
+		{
+			PHASE_TIMER(OPTIMIZER_UPDATE);
+			pop = cmaes->samplePopulation();
+		}
 		if (!currentGameRunner->run(pop, N, arFunvals))
 		{
 			printf("Error while evaluating weights\n");
@@ -61,7 +65,10 @@ class AbsCmaEsOptimizer : public WeightsOptimizer
 		{
 			arFunvals[i] = this->rand.getValue(1);
 		}*/
-		cmaes->updateDistribution(arFunvals);
+		{
+			PHASE_TIMER(OPTIMIZER_UPDATE);
+			cmaes->updateDistribution(arFunvals);
+		}
 
 		onEndLearning();
 
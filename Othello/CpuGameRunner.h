@@ -3,11 +3,18 @@
 
 #include "Othello.h"
 #include "WeightsOptimizer.h"
+#include "WorkStealingScheduler.h"
+#include "SearchPlayer.h"
+#include "EndgamePlayer.h"
+#include "MctsPlayer.h"
+#include "BatchedGames.h"
 
 class CPUGameRunner : public GameRunner
 {
 protected:
 	Rand rand;
+	// Generator ziaren zadan, niezalezny od liczby watkow.
+	Rand taskRand;
 	int nThreads;
 	int perThread;
 
@@ -16,37 +23,15 @@ protected:
 	Othello **othellos;
 	int nExperts;
 
-	void play(OthelloPlayer *player, Othello *othello, Board::EVALUATION_TYPE *const*weights, int nWeights, Board::EVALUATION_TYPE *results, int minBoard, int maxBoard)
-	{
-		auto boards = conf->getBoards();
-		int nBoards = boards->getNBoards();
-
-		for (int i = 0; i < nWeights; i++)
-		{
-			if (weights[i] != nullptr)
-				player->setWeights(weights[i]);
-			Board::EVALUATION_TYPE result = 0;
-			int games = nBoards * nExperts;
-            for (int b = 0; b < nBoards; b++)
-			{
-                Board board(boards->getBoardValues(b));
-                for (int e = 0; e < nExperts; e++)
-				{
-				    Board b(board);
-				    auto res = othello->playDouble(&b, 0, e+1);
-					//auto res = Othello::playDouble(b, player, experts[i], i);
-					result += res.item1;
-				}
-			}
-			result /= games;
-			results[i] = 1 - result;
-		}
-	}
-
-	void static runThreaded(CPUGameRunner *runner, OthelloPlayer *player, Othello *othello, Board::EVALUATION_TYPE *const*weights, int nWeights, Board::EVALUATION_TYPE *results)
-	{
-		runner->play(player, othello, weights, nWeights, results, 0, runner->conf->getBoards()->getNBoards());
-	}
+	// Wagi gracza z konfiguracji, uzywane dla kandydatow podanych jako nullptr.
+	Board::EVALUATION_TYPE *initialWeights;
+	// Pamiec ruchow ekspertow (nullptr - wylaczona).
+	ExpertMoveCache *moveCache;
+	// Rozmiar pamieci ocen graczy (0 - wylaczona).
+	int evalCacheSize;
+	// Ksiazki otwarc ekspertow i kandydatow (nullptr - brak).
+	OpeningBook *expertBook;
+	OpeningBook *playerBook;
 
 	void clear()
 	{
@@ -72,6 +57,14 @@ protected:
 			nExperts = 0;
 			experts = nullptr;
 		}
+		delete[] initialWeights;
+		initialWeights = nullptr;
+		delete moveCache;
+		moveCache = nullptr;
+		delete expertBook;
+		expertBook = nullptr;
+		delete playerBook;
+		playerBook = nullptr;
 	}
 
 	virtual void _setPlayerFreq(float freq)
@@ -85,13 +78,62 @@ protected:
 		for (int i = 0; i < nExperts; i++)
 			experts[i]->setRandomMoveFreq(freq);
 	}
+
+	// Opakowuje gracza w SearchPlayer, jesli konfiguracja podaje glebokosc
+	// (<prefix>_search_depth) lub limit ocenianych pozycji (<prefix>_search_nodes)
+	// albo czasu w sekundach (<prefix>_search_time) na ruch. Opcja <prefix>_search_threads
+	// wlacza przeszukiwanie rownolegle kazdej pozycji.
+	OthelloPlayer *addSearch(OthelloPlayer *player, const std::string &prefix)
+	{
+		int64_t maxNodes = (int64_t)conf->getOption(prefix + "_search_nodes", 0);
+		double maxTime = conf->getOption(prefix + "_search_time", 0);
+		int maxDepth = (int)conf->getOption(prefix + "_search_depth", maxNodes > 0 || maxTime > 0 ? SearchPlayer::MAX_DEPTH : 1);
+		if (player == nullptr || maxDepth <= 1)
+			return player;
+		return new SearchPlayer(player, maxDepth, maxNodes, (int)conf->getOption(prefix + "_search_threads", 1), maxTime);
+	}
+
+	// Opakowuje gracza w MctsPlayer, jesli konfiguracja podaje liczbe symulacji
+	// (<prefix>_mcts_playouts) lub czas w sekundach (<prefix>_mcts_time) na ruch.
+	// Opcje: <prefix>_mcts_threads - liczba watkow symulacji, <prefix>_mcts_nodes - rozmiar
+	// puli wezlow w kazdej grze, <prefix>_mcts_random - czestosc losowych ruchow w symulacjach,
+	// <prefix>_mcts_puct - wybor ruchow wedlug PUCT z temperatura mcts_temperature,
+	// mcts_c - wspolczynnik eksploracji.
+	OthelloPlayer *addMcts(OthelloPlayer *player, const std::string &prefix)
+	{
+		int64_t maxPlayouts = (int64_t)conf->getOption(prefix + "_mcts_playouts", 0);
+		double maxTime = conf->getOption(prefix + "_mcts_time", 0);
+		if (player == nullptr || (maxPlayouts <= 0 && maxTime <= 0))
+			return player;
+		return new MctsPlayer(player, maxPlayouts, (int)conf->getOption(prefix + "_mcts_threads", 1), maxTime,
+			(int)conf->getOption(prefix + "_mcts_nodes", MctsPlayer::DEFAULT_NODES), conf->getOption("mcts_c", 1.0f),
+			conf->getOption(prefix + "_mcts_random", 0), conf->getOption(prefix + "_mcts_puct", 0) != 0,
+			conf->getOption("mcts_temperature", 1.0f));
+	}
+
+	// Opakowuje gracza w EndgamePlayer, jesli konfiguracja podaje liczbe pustych pol
+	// (<prefix>_endgame_empties), od ktorej gracz gra idealnie. Rozmiar tablicy
+	// transpozycji w kazdej grze podaje opcja endgame_tt.
+	OthelloPlayer *addEndgame(OthelloPlayer *player, const std::string &prefix)
+	{
+		int maxEmpties = (int)conf->getOption(prefix + "_endgame_empties", 0);
+		if (player == nullptr || maxEmpties <= 0)
+			return player;
+		return new EndgamePlayer(player, maxEmpties, (int)conf->getOption("endgame_tt", 1 << 14));
+	}
 public:
 	CPUGameRunner(int nThreads, int perThread, int seed) :
 		rand(seed),
+		taskRand(seed),
 		experts(nullptr),
 		nExperts(0),
 		players(nullptr),
 		othellos(nullptr),
+		initialWeights(nullptr),
+		moveCache(nullptr),
+		evalCacheSize(0),
+		expertBook(nullptr),
+		playerBook(nullptr),
 		nThreads(nThreads),
 		perThread(perThread)
 	{
@@ -117,12 +159,16 @@ public:
 				printf("Cannot load player %s\n", conf->getPlayerName(i).c_str());
 				return false;
 			}
+			players[i] = addEndgame(addMcts(addSearch(players[i], "player"), "player"), "player");
 		}
 
+		initialWeights = new Board::EVALUATION_TYPE[players[0]->getNWeights()];
+		players[0]->getWeights(initialWeights);
+
 		nExperts = conf->getNPlayers() - 1;
 		experts = new OthelloPlayer*[nExperts];
 		for (int i = 0; i < nExperts; i++)
-			experts[i] = conf->getPlayerLoader(i + 1)->getPlayer(rand.rand(), conf->getPlayerNeg(i + 1));
+			experts[i] = addEndgame(addMcts(addSearch(conf->getPlayerLoader(i + 1)->getPlayer(rand.rand(), conf->getPlayerNeg(i + 1)), "expert"), "expert"), "expert");
 
         othellos = new Othello*[nThreads];
         for (int i = 0; i < nThreads; i++)
@@ -130,9 +176,66 @@ public:
             othellos[i] = new Othello(players[i], experts, nExperts, rand.rand());
         }
 
+		setExpertMoveCache((int)conf->getOption("expert_move_cache", 0));
+		setEvalCache((int)conf->getOption("eval_cache", 0));
+		setOpeningBooks(conf->getOptionString("expert_opening_book", ""), conf->getOptionString("player_opening_book", ""),
+			(int)conf->getOption("opening_book_min_games", 1));
+
 		return true;
 	}
 
+	// Wlacza wspolna dla watkow pamiec ruchow ekspertow o nEntries wpisach
+	// (0 - wylacza). Eksperci graja stalymi wagami, wiec wyniki gier sie nie zmieniaja.
+	void setExpertMoveCache(int nEntries)
+	{
+		delete moveCache;
+		moveCache = nEntries > 0 ? new ExpertMoveCache(nEntries) : nullptr;
+		for (int i = 0; i < nExperts; i++)
+			experts[i]->setMoveCache(moveCache, i);
+	}
+
+	ExpertMoveCache *getExpertMoveCache()
+	{
+		return moveCache;
+	}
+
+	// Wlacza ksiazki otwarc z plikow (pusta nazwa - bez ksiazki) dla ekspertow i kandydatow.
+	// Ruchy z ksiazki nie zaleza od wag, wiec ksiazka kandydatow zmienia ocene ich wag.
+	void setOpeningBooks(const std::string &expertFile, const std::string &playerFile, int minGames)
+	{
+		delete expertBook;
+		delete playerBook;
+		expertBook = expertFile.empty() ? nullptr : OpeningBook::load(expertFile);
+		playerBook = playerFile.empty() ? nullptr : OpeningBook::load(playerFile);
+		for (int i = 0; i < nThreads; i++)
+			players[i]->setOpeningBook(playerBook, minGames);
+		for (int i = 0; i < nExperts; i++)
+			experts[i]->setOpeningBook(expertBook, minGames);
+	}
+
+	// Wlacza pamiec ocen ruchow o nEntries wpisach dla kazdego gracza w kazdym
+	// watku (0 - wylacza). Pamiec tworzona jest przy pierwszym ruchu gracza.
+	void setEvalCache(int nEntries)
+	{
+		evalCacheSize = nEntries;
+		for (int i = 0; i < nThreads; i++)
+			players[i]->setEvalCache(nEntries);
+		for (int i = 0; i < nExperts; i++)
+			experts[i]->setEvalCache(nEntries);
+	}
+
+	void printEvalCacheStats(FILE *file = stdout)
+	{
+		if (evalCacheSize <= 0)
+			return;
+		int64_t hits = 0, misses = 0;
+		for (int i = 0; i < nThreads; i++)
+			othellos[i]->addEvalCacheStats(&hits, &misses);
+		int64_t lookups = hits + misses;
+		fprintf(file, "Eval cache: %d entries per player and thread, %lld lookups, %lld hits (%.2f%%)\n", evalCacheSize,
+			(long long)lookups, (long long)hits, lookups > 0 ? 100.0 * hits / lookups : 0.0);
+	}
+
 	int getNPlayers()
 	{
 		return nThreads;
@@ -157,48 +260,201 @@ public:
 	{
 	}
 
+	// Pojedynczy kandydat dzielony jest na zadania (ekspert, plansza) pomiedzy
+	// wszystkie watki, wiec runTest nie musi powielac jego wag.
+	int getMinimumNWeights()
+	{
+		return 1;
+	}
+
+	// Ocenia dowolna liczbe kandydatow. Kazda para gier (kandydat, ekspert, plansza)
+	// jest osobnym zadaniem harmonogramu z kradzieza pracy. Przed kazdym zadaniem
+	// ustawiane jest ziarno zalezne tylko od numeru zadania, a wyniki sumowane sa
+	// w stalej kolejnosci, wiec ocena kandydata nie zalezy od liczby watkow
+	// ani od przydzialu zadan.
 	bool run(Board::EVALUATION_TYPE *const*weights, int nWeights, Board::EVALUATION_TYPE *results)
 	{
-		if (nThreads * perThread == nWeights || nThreads == nWeights)
+		BoardLoader *boards = conf->getBoards();
+		int nBoards = boards->getNBoards();
+		int gamesPerWeights = nBoards * nExperts;
+		if (gamesPerWeights == 0)
 		{
-#ifndef NOT_TH
-			int perTh = nWeights / nThreads;
-			std::thread **th = new std::thread*[nThreads];
-			for (int i = 0; i < nThreads; i++)
+			printf("Brak plansz lub ekspertow\n");
+			return false;
+		}
+
+		int nTasks = nWeights * gamesPerWeights;
+		Board::EVALUATION_TYPE *scores = new Board::EVALUATION_TYPE[nTasks];
+		int *loadedWeights = new int[nThreads];
+		for (int i = 0; i < nThreads; i++)
+			loadedWeights[i] = -1;
+		unsigned seed = taskRand.rand();
+
+		WorkStealingScheduler::run(nThreads, nTasks, [&](int task, int worker)
+		{
+			int w = task / gamesPerWeights;
+			int b = task % gamesPerWeights / nExperts;
+			int e = task % nExperts;
+			if (loadedWeights[worker] != w)
 			{
-				auto p = players[i];
-				int index = i * perTh;
-				th[i] = new std::thread(&CPUGameRunner::runThreaded, this, p, othellos[i], &weights[index], perTh, &results[index]);
+				players[worker]->setWeights(weights[w] != nullptr ? weights[w] : initialWeights);
+				loadedWeights[worker] = w;
 			}
 
-			for (int i = 0; i < nThreads; i++)
-				th[i]->join();
+			othellos[worker]->setSeed(seed + task);
+			Board board(boards->getBoardValues(b));
+			scores[task] = othellos[worker]->playDouble(&board, 0, e + 1).item1;
+		});
 
-			for (int i = 0; i < nThreads; i++)
-				delete th[i];
+		for (int w = 0; w < nWeights; w++)
+		{
+			Board::EVALUATION_TYPE result = 0;
+			for (int g = 0; g < gamesPerWeights; g++)
+				result += scores[w * gamesPerWeights + g];
+			results[w] = 1 - result / gamesPerWeights;
+		}
 
-			delete[] th;
-#else
-			int perTh = nWeights / nThreads;
-			for (int i = 0; i < nThreads; i++)
+		delete[] loadedWeights;
+		delete[] scores;
+		return true;
+	}
+};
+
+// Ocenia kandydatow grami rozgrywanymi paczkami przez BatchedGames (wybierany opcja
+// konfiguracji batched_games rozna od 0). Zadaniem harmonogramu
+// jest trojka (kandydat, ekspert, kolor kandydata) obejmujaca gry od wszystkich plansz,
+// rozgrywane po batch_size naraz (opcja konfiguracji, domyslnie 32). Ziarna gier zaleza
+// tylko od numeru zadania i planszy, wiec wyniki nie zaleza od liczby watkow ani od
+// rozmiaru paczki. Obslugiwani sa gracze WPCPlayer i DynamicNTuplePlayer bez przeszukiwania;
+// dla pozostalych graczy lub z ksiazkami otwarc ocena wykonywana jest jak w SimpleCPUGameRunner.
+// Pamieci ruchow i ocen nie sa uzywane (nie zmieniaja wynikow gier).
+class BatchedCPUGameRunner : public SimpleCPUGameRunner
+{
+public:
+	BatchedCPUGameRunner(int nThreads, int perThread, int seed) :
+		SimpleCPUGameRunner(nThreads, perThread, seed),
+		batched(false)
+	{
+	}
+
+	~BatchedCPUGameRunner()
+	{
+		clearBatched();
+	}
+
+	bool init(Configuration *conf)
+	{
+		clearBatched();
+		if (!SimpleCPUGameRunner::init(conf))
+			return false;
+
+		playerNetwork = BatchedGames::getNetwork(players[0]);
+		batched = playerNetwork != nullptr;
+		expertNetworks.resize(nExperts);
+		expertWeights.resize(nExperts);
+		for (int i = 0; i < nExperts; i++)
+		{
+			expertNetworks[i] = BatchedGames::getNetwork(experts[i]);
+			if (expertNetworks[i] == nullptr)
 			{
-				auto p = players[i];
-				int index = i * perTh;
-				runThreaded(this, p, othellos[0], &weights[index], perTh, &results[index]);
+				batched = false;
+				continue;
 			}
-#endif // TH
-			return true;
+			AlignedArray<Board::EVALUATION_TYPE> weights(experts[i]->getNWeights());
+			experts[i]->getWeights(weights.get());
+			const Board::EVALUATION_TYPE *networkWeights = BatchedGames::getWeights(experts[i], weights.get(), expertWeights[i]);
+			if (networkWeights == weights.get())
+				expertWeights[i] = weights;
 		}
-		else if (nWeights == 1)
+		if (!batched)
+			printf("Gry w paczkach tylko dla graczy WPC i sieci krotek bez przeszukiwania - gry pojedyncze\n");
+
+		int batchSize = (int)conf->getOption("batch_size", BatchedGames::DEFAULT_BATCH_SIZE);
+		for (int i = 0; i < nThreads; i++)
+			games.push_back(new BatchedGames(batchSize));
+		playerWeights.resize(nThreads);
+		return true;
+	}
+
+	bool run(Board::EVALUATION_TYPE *const*weights, int nWeights, Board::EVALUATION_TYPE *results)
+	{
+		// ruchy z ksiazek otwarc nie sa odtwarzane w paczkach
+		if (!batched || expertBook != nullptr || playerBook != nullptr)
+			return SimpleCPUGameRunner::run(weights, nWeights, results);
+
+		BoardLoader *boards = conf->getBoards();
+		int nBoards = boards->getNBoards();
+		if (nBoards * nExperts == 0)
 		{
-			runThreaded(this, players[0], othellos[0], weights, 1, results);
-			return true;
+			printf("Brak plansz lub ekspertow\n");
+			return false;
 		}
-		else
+
+		int nTasks = nWeights * nExperts * 2;
+		Board::EVALUATION_TYPE *scores = new Board::EVALUATION_TYPE[nTasks * nBoards];
+		unsigned seed = taskRand.rand();
+
+		WorkStealingScheduler::run(nThreads, nTasks, [&](int task, int worker)
 		{
-			printf("Niepoprawna ilosc wag: %d zamiast %d lub %d\n", nWeights, nThreads * perThread, nThreads);
-			return false;
+			int w = task / (2 * nExperts);
+			int e = task / 2 % nExperts;
+			bool playerBlack = task % 2 == 0;
+
+			BatchedGames::Player player;
+			player.network = playerNetwork.get();
+			player.weights = BatchedGames::getWeights(players[0], weights[w] != nullptr ? weights[w] : initialWeights, playerWeights[worker]);
+			player.randomMoveFreq = players[0]->getRandomMoveFreq();
+			player.negated = conf->getPlayerNeg(0);
+
+			BatchedGames::Player expert;
+			expert.network = expertNetworks[e].get();
+			expert.weights = expertWeights[e].get();
+			expert.randomMoveFreq = experts[e]->getRandomMoveFreq();
+			expert.negated = conf->getPlayerNeg(e + 1);
+
+			Board::EVALUATION_TYPE *taskScores = scores + task * nBoards;
+			games[worker]->play(playerBlack ? player : expert, playerBlack ? expert : player, boards, seed + task * nBoards, taskScores);
+			if (!playerBlack)
+			{
+				for (int b = 0; b < nBoards; b++)
+					taskScores[b] = 1 - taskScores[b];
+			}
+		});
+
+		int gamesPerWeights = 2 * nExperts * nBoards;
+		for (int w = 0; w < nWeights; w++)
+		{
+			Board::EVALUATION_TYPE result = 0;
+			for (int g = 0; g < gamesPerWeights; g++)
+				result += scores[w * gamesPerWeights + g];
+			results[w] = 1 - result / gamesPerWeights;
 		}
+
+		delete[] scores;
+		return true;
+	}
+private:
+	// Czy kandydaci i eksperci moga grac w paczkach.
+	bool batched;
+	std::shared_ptr<const NTupleNetwork> playerNetwork;
+	std::vector<std::shared_ptr<const NTupleNetwork> > expertNetworks;
+	// Wagi ekspertow w ukladzie ich sieci.
+	std::vector<AlignedArray<Board::EVALUATION_TYPE> > expertWeights;
+	// Wagi kandydata WPC zamienione na wagi sieci, osobno dla kazdego watku.
+	std::vector<AlignedArray<Board::EVALUATION_TYPE> > playerWeights;
+	// Rozgrywki w paczkach, osobno dla kazdego watku.
+	std::vector<BatchedGames *> games;
+
+	void clearBatched()
+	{
+		for (size_t i = 0; i < games.size(); i++)
+			delete games[i];
+		games.clear();
+		playerNetwork.reset();
+		expertNetworks.clear();
+		expertWeights.clear();
+		playerWeights.clear();
+		batched = false;
 	}
 };
 
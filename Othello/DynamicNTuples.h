@@ -0,0 +1,227 @@
+#ifndef DYNAMIC_N_TUPLES_H
+#define DYNAMIC_N_TUPLES_H
+
+#include <memory>
+#include "Header.h"
+#include "Board.h"
+#include "AlignedArray.h"
+#include "PlayerParams.h"
+
+// Niezmienny ksztalt sieci krotek: polozenie wag kazdej krotki oraz tablica
+// krotek zawierajacych kazde pole. Wspoldzielony przez wszystkich graczy
+// utworzonych z tej samej sieci, niezaleznie od watku.
+class NTupleNetwork
+{
+public:
+	// Krotka zawierajaca pole wraz z waga (potega 3) pola w indeksie krotki.
+	struct TuplePower
+	{
+		int tuple;
+		int power;
+	};
+
+	DEF NTupleNetwork(int nWeights, int nTuples, Board::INDEX_TYPE *fields, int *allTuples) :
+		weightOffsets(nTuples), maxIndexes(nTuples)
+	{
+		this->nWeights = nWeights;
+		this->nTuples = nTuples;
+
+		for (int i = 0; i < nTuples; i++)
+		{
+			int n = allTuples[3 * i];
+			int maxIndex = 1;
+			for (int j = 0; j < n; j++)
+				maxIndex *= 3;
+			maxIndexes[i] = maxIndex - 1;
+			weightOffsets[i] = allTuples[3 * i + 2];
+		}
+
+		calculatePos(fields, allTuples);
+	}
+
+	int nWeights;
+	int nTuples;
+	// Poczatek wag kazdej krotki w tablicy wag.
+	AlignedArray<int> weightOffsets;
+	// Najwiekszy indeks kazdej krotki (3^n - 1).
+	AlignedArray<int> maxIndexes;
+	// Krotki zawierajace pole o numerze bitu b: tuplesInPos[posBegin[b]..posBegin[b+1]).
+	int posBegin[65];
+	AlignedArray<TuplePower> tuplesInPos;
+private:
+	DEF void calculatePos(Board::INDEX_TYPE *fields, int *allTuples)
+	{
+		int count = 0;
+		for (int i = 0; i < nTuples; i++)
+			count += allTuples[3 * i];
+		tuplesInPos.resize(count);
+
+		count = 0;
+		for (int bit = 0; bit < 64; bit++)
+		{
+			posBegin[bit] = count;
+			Board::INDEX_TYPE field = Board::getFieldIndex(bit);
+			for (int i = 0; i < nTuples; i++)
+			{
+				int n = allTuples[3 * i];
+				Board::INDEX_TYPE *f = fields + allTuples[3 * i + 1];
+				int power = maxIndexes[i] + 1;
+				for (int k = 0; k < n; k++)
+				{
+					power /= 3;
+					if (f[k] == field)
+					{
+						tuplesInPos[count].tuple = i;
+						tuplesInPos[count].power = power;
+						count++;
+					}
+				}
+			}
+		}
+		posBegin[64] = count;
+	}
+};
+
+// Siec krotek o ksztalcie (liczbie pol, wag i krotek) ustalanym podczas wczytywania.
+// Dziala jak NTuples, lecz wszystkie tablice sa plaskie, umieszczone na stercie
+// i wyrownane do linii pamieci podrecznej.
+// Kopie wspoldziela ksztalt sieci i wagi - wagi kopiowane sa dopiero przy setWeights,
+// wiec eksperci zajmuja jedna kopie tablic niezaleznie od liczby watkow,
+// a oceniani kandydaci otrzymuja wlasne.
+class DynamicNTuples
+{
+public:
+	DEF DynamicNTuples(int nWeights, int nTuples, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *allTuples) :
+		network(new NTupleNetwork(nWeights, nTuples, fields, allTuples)),
+		weights(new AlignedArray<Board::EVALUATION_TYPE>(nWeights))
+	{
+		memcpy(this->weights->get(), weights, sizeof(Board::EVALUATION_TYPE) * nWeights);
+	}
+
+	DEF int getNWeights() const
+	{
+		return network->nWeights;
+	}
+
+	DEF int getNTuples() const
+	{
+		return network->nTuples;
+	}
+
+	DEF const Board::EVALUATION_TYPE *getWeights() const
+	{
+		return weights->get();
+	}
+
+	DEF const std::shared_ptr<const NTupleNetwork> &getNetwork() const
+	{
+		return network;
+	}
+
+	// Ustawia wagi, tworzac wlasna kopie tablicy, jesli jest wspoldzielona.
+	DEF void setWeights(const Board::EVALUATION_TYPE *weights)
+	{
+		if (this->weights.use_count() > 1)
+			this->weights.reset(new AlignedArray<Board::EVALUATION_TYPE>(network->nWeights));
+		memcpy(this->weights->get(), weights, sizeof(Board::EVALUATION_TYPE) * network->nWeights);
+	}
+
+	// Ocenia ruch na podstawie indeksow krotek utrzymywanych w parametrach gracza
+	// (zob. NTuples::getValue).
+	DEF Board::EVALUATION_TYPE getValue(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, DynamicNTuplePlayerParams *p) const
+	{
+		synchronize(board, p);
+
+		p->nTouched = 0;
+		Board::BITBOARD_TYPE mask = flips;
+		while (mask)
+		{
+			addDeltas(p, Board::bitScanForward(mask), -2 * player);
+			mask &= mask - 1;
+		}
+		addDeltas(p, Board::getBitIndex(move), -player);
+
+		const Board::EVALUATION_TYPE *w = weights->get();
+		const int *offsets = network->weightOffsets.get();
+		const int *indexes = p->tupleIndexes.get();
+		const int *deltas = p->deltas.get();
+		const int *touched = p->touched.get();
+		int nTouched = p->nTouched;
+
+		Board::EVALUATION_TYPE result = 0;
+		if (perspective == Board::BLACK)
+		{
+			for (int i = 0; i < nTouched; i++)
+				result -= w[offsets[touched[i]] + indexes[touched[i]]];
+			for (int i = 0; i < nTouched; i++)
+				result += w[offsets[touched[i]] + indexes[touched[i]] + deltas[touched[i]]];
+		}
+		else
+		{
+			const int *maxIdx = network->maxIndexes.get();
+			for (int i = 0; i < nTouched; i++)
+				result -= w[offsets[touched[i]] + maxIdx[touched[i]] - indexes[touched[i]]];
+			for (int i = 0; i < nTouched; i++)
+				result += w[offsets[touched[i]] + maxIdx[touched[i]] - indexes[touched[i]] - deltas[touched[i]]];
+		}
+
+		for (int i = 0; i < nTouched; i++)
+			p->isTouched[touched[i]] = 0;
+
+		return result;
+	}
+
+	// Ustawia indeksy krotek odpowiadajace pustej planszy.
+	DEF void initParams(DynamicNTuplePlayerParams *p) const
+	{
+		p->pawns[0] = 0;
+		p->pawns[1] = 0;
+		for (int i = 0; i < network->nTuples; i++)
+			p->tupleIndexes[i] = network->maxIndexes[i] / 2;
+	}
+
+	// Uaktualnia indeksy krotek o pola, ktore zmienily sie od ostatniego wywolania.
+	DEF void synchronize(Board *board, DynamicNTuplePlayerParams *p) const
+	{
+		Board::BITBOARD_TYPE black = board->getPawns(Board::BLACK);
+		Board::BITBOARD_TYPE white = board->getPawns(Board::WHITE);
+		Board::BITBOARD_TYPE changed = (black ^ p->pawns[0]) | (white ^ p->pawns[1]);
+		int *indexes = p->tupleIndexes.get();
+		const int *posBegin = network->posBegin;
+		const NTupleNetwork::TuplePower *tuplesInPos = network->tuplesInPos.get();
+		while (changed)
+		{
+			int bit = Board::bitScanForward(changed);
+			int oldValue = (int)((p->pawns[1] >> bit) & 1) - (int)((p->pawns[0] >> bit) & 1);
+			int newValue = (int)((white >> bit) & 1) - (int)((black >> bit) & 1);
+			int digitDelta = oldValue - newValue;
+			for (int j = posBegin[bit]; j < posBegin[bit + 1]; j++)
+				indexes[tuplesInPos[j].tuple] += digitDelta * tuplesInPos[j].power;
+			changed &= changed - 1;
+		}
+		p->pawns[0] = black;
+		p->pawns[1] = white;
+	}
+private:
+	std::shared_ptr<const NTupleNetwork> network;
+	std::shared_ptr<AlignedArray<Board::EVALUATION_TYPE> > weights;
+
+	// Dodaje zmiane cyfry pola do zmian indeksow zawierajacych je krotek.
+	DEF void addDeltas(DynamicNTuplePlayerParams *p, int bit, int digitDelta) const
+	{
+		const NTupleNetwork::TuplePower *tuplesInPos = network->tuplesInPos.get();
+		for (int j = network->posBegin[bit]; j < network->posBegin[bit + 1]; j++)
+		{
+			int t = tuplesInPos[j].tuple;
+			if (!p->isTouched[t])
+			{
+				p->isTouched[t] = 1;
+				p->touched[p->nTouched++] = t;
+				p->deltas[t] = 0;
+			}
+			p->deltas[t] += digitDelta * tuplesInPos[j].power;
+		}
+	}
+};
+
+#endif //DYNAMIC_N_TUPLES_H
@@ -0,0 +1,151 @@
+#ifndef ENDGAME_PLAYER_H
+#define ENDGAME_PLAYER_H
+
+#include "Header.h"
+#include "Board.h"
+#include "PlayerParams.h"
+#include "OthelloPlayer.h"
+#include "EndgameSolver.h"
+#include "ExpertMoveCache.h"
+
+// Stan gracza EndgamePlayer w jednej grze: parametry opakowanego gracza
+// i rozwiazywacz koncowek z wlasna tablica transpozycji.
+class EndgamePlayerParams : public PlayerParams
+{
+public:
+	DEF EndgamePlayerParams(int seed, PlayerParams *params, int nEntries) :
+		PlayerParams(seed), params(params), solver(nEntries)
+	{
+	}
+
+	DEF ~EndgamePlayerParams()
+	{
+		delete params;
+	}
+
+	DEF void setSeed(int seed)
+	{
+		PlayerParams::setSeed(seed);
+		if (params != nullptr)
+			params->setSeed(rand.rand());
+	}
+
+	DEF void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		PlayerParams::addEvalCacheStats(hits, misses);
+		if (params != nullptr)
+			params->addEvalCacheStats(hits, misses);
+	}
+
+	// Parametry opakowanego gracza.
+	PlayerParams *params;
+	EndgameSolver solver;
+};
+
+// Gracz grajacy idealnie, gdy na planszy zostalo nie wiecej niz maxEmpties pustych pol
+// (EndgameSolver), a wczesniej jak opakowany gracz. Sposrod ruchow o najlepszym
+// wyniku wybiera losowo, tak jak CpuPlayer sposrod ruchow o rownej ocenie.
+class EndgamePlayer : public OthelloPlayer
+{
+public:
+	// player - gracz przed koncowka, usuwany wraz z obiektem;
+	// nEntries - rozmiar tablicy transpozycji w parametrach kazdej gry.
+	DEF EndgamePlayer(OthelloPlayer *player, int maxEmpties, int nEntries = 1 << 14)
+		: OthelloPlayer()
+	{
+		this->player = player;
+		this->maxEmpties = maxEmpties;
+		this->nEntries = nEntries;
+		moveCache = nullptr;
+		moveCacheId = 0;
+	}
+
+	DEF ~EndgamePlayer()
+	{
+		delete player;
+	}
+
+	DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *p, GameData *data)
+	{
+		EndgamePlayerParams *par = static_cast<EndgamePlayerParams *>(p);
+		if (EndgameSolver::getEmpties(board) > maxEmpties)
+			return player->getMove(board, validMoves, playerColor, negated, par->params, data);
+
+		PHASE_TIMER(EVALUATION);
+		// wynik zalezy tylko od pozycji, wiec numer negacji nie jest potrzebny
+		if (moveCache == nullptr || !moveCache->get(2 * moveCacheId, board->getHash(playerColor), validMoves, par->bestMoves))
+		{
+			par->solver.solve(board, validMoves, playerColor, par->bestMoves);
+			if (moveCache != nullptr)
+				moveCache->put(2 * moveCacheId, board->getHash(playerColor), validMoves, par->bestMoves);
+		}
+
+		if (par->bestMoves.size() == 1)
+			return par->bestMoves[0];
+#ifdef MIN_MOVE
+		Board::INDEX_TYPE min = 101;
+		for (int i = 0; i < par->bestMoves.size(); i++)
+			if (min > par->bestMoves[i])
+				min = par->bestMoves[i];
+		return min;
+#else
+		return par->bestMoves[par->rand.getValue(par->bestMoves.size())];
+#endif
+	}
+
+	DEF bool isNegated(Board *board)
+	{
+		return player->isNegated(board);
+	}
+
+	DEF int getNWeights()
+	{
+		return player->getNWeights();
+	}
+
+	DEF void getWeights(Board::EVALUATION_TYPE *weights)
+	{
+		player->getWeights(weights);
+	}
+
+	DEF void setWeights(const Board::EVALUATION_TYPE *weights)
+	{
+		player->setWeights(weights);
+	}
+
+	DEF PlayerParams *getPlayerParams(int seed)
+	{
+		return new EndgamePlayerParams(seed, player->getPlayerParams(seed), nEntries);
+	}
+
+	// Koncowki i wczesniejsze pozycje nie powtarzaja sie, wiec gracze moga dzielic numer w pamieci.
+	DEF void setMoveCache(ExpertMoveCache *cache, int id)
+	{
+		moveCache = cache;
+		moveCacheId = id;
+		player->setMoveCache(cache, id);
+	}
+
+	DEF void setEvalCache(int nEntries)
+	{
+		player->setEvalCache(nEntries);
+	}
+
+	DEF void setOpeningBook(const OpeningBook *book, int minGames)
+	{
+		player->setOpeningBook(book, minGames);
+	}
+
+	DEF CpuPlayer *getEvaluator(Board *board, PlayerParams *p, PlayerParams **evalParams)
+	{
+		return player->getEvaluator(board, static_cast<EndgamePlayerParams *>(p)->params, evalParams);
+	}
+private:
+	OthelloPlayer *player;
+	int maxEmpties;
+	int nEntries;
+	ExpertMoveCache *moveCache;
+	int moveCacheId;
+};
+
+#endif //ENDGAME_PLAYER_H
@@ -0,0 +1,293 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <algorithm>
+#include "Header.h"
+#include "Board.h"
+#include "Vector.h"
+#include "AlignedArray.h"
+#include "AnyLoader.h"
+#include "Random.h"
+#include "Watch.h"
+
+// Dokladne rozwiazywanie koncowek gry przeszukiwaniem alfa-beta (negamax) do konca gry.
+// Wynikiem jest roznica pionow gracza wykonujacego ruch i przeciwnika po zakonczeniu
+// gry przy idealnej grze obu stron (puste pola nie sa doliczane - jak w Board::result).
+// Ruchy porzadkowane sa wedlug najlepszego ruchu z tablicy transpozycji i najmniejszej
+// liczby ruchow przeciwnika (fastest-first), a przy malej liczbie pustych pol
+// wedlug parzystosci pustych pol w cwiartkach planszy.
+// Tablica transpozycji przechowuje granice wyniku, ktore zaleza tylko od pozycji,
+// wiec moze byc uzywana przez kolejne wywolania. Obiekt nie jest wspoldzielony miedzy watkami.
+class EndgameSolver
+{
+public:
+	// Najwiekszy mozliwy wynik.
+	static const int MAX_SCORE = 64;
+	// Najmniejsza liczba pustych pol, od ktorej uzywana jest tablica transpozycji.
+	static const int TT_MIN_EMPTIES = 7;
+	// Najmniejsza liczba pustych pol, od ktorej ruchy porzadkowane sa wedlug ruchow przeciwnika.
+	static const int FASTEST_FIRST_MIN_EMPTIES = 7;
+
+	DEF EndgameSolver(int nEntries = 1 << 14)
+	{
+		size = 1;
+		while (size < nEntries)
+			size <<= 1;
+		entries.resize(size);
+		for (int i = 0; i < size; i++)
+		{
+			entries[i].key = 0;
+			entries[i].move = -1;
+		}
+		nodes = 0;
+	}
+
+	// Wynik gry przy idealnej grze, z perspektywy gracza player.
+	DEF int solve(Board *board, Board::BOARD_ELEMENT_TYPE player)
+	{
+		return negamax(board, player, -MAX_SCORE - 1, MAX_SCORE + 1, false, 0);
+	}
+
+	// Wypelnia bestMoves wszystkimi ruchami z validMoves prowadzacymi do najlepszego
+	// wyniku i zwraca ten wynik (z perspektywy gracza player).
+	DEF int solve(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE player, Vector<Board::INDEX_TYPE, Board::SIZE> &bestMoves)
+	{
+		int nMoves = validMoves->size();
+		int order[Board::MAX_CH_POS];
+		int scores[Board::MAX_CH_POS];
+		orderMoves(board, *validMoves, player, getEmpties(board), order);
+
+		// okno obejmuje ruchy rowne najlepszemu, wiec remisy znane sa dokladnie
+		int best = -MAX_SCORE - 1;
+		for (int k = 0; k < nMoves; k++)
+		{
+			int i = order[k];
+			board->makeMove((*validMoves)[i], validMoves->getFlips(i), player);
+			scores[i] = -negamax(board, -player, -MAX_SCORE - 1, -(best - 1), false, 1);
+			board->undoMove((*validMoves)[i], validMoves->getFlips(i), player);
+			if (scores[i] > best)
+				best = scores[i];
+		}
+
+		bestMoves.clear();
+		for (int i = 0; i < nMoves; i++)
+		{
+			if (scores[i] == best)
+				bestMoves.add((*validMoves)[i]);
+		}
+		return best;
+	}
+
+	// Liczba odwiedzonych pozycji od utworzenia obiektu.
+	DEF int64_t getNodes()
+	{
+		return nodes;
+	}
+
+	DEF static int getEmpties(Board *board)
+	{
+		return 64 - board->getNPawns();
+	}
+
+	// Rozwiazuje pozycje z nEmpties pustymi polami, uzyskane losowymi ruchami z kolejnych
+	// plansz (w kolejnosci z pliku), i wypisuje liczbe odwiedzonych pozycji na sekunde.
+	DEF static void benchmark(BoardLoader *boards, int nEmpties, int nPositions, int seed, int nEntries = 1 << 20)
+	{
+		Random<int> random(seed);
+		EndgameSolver solver(nEntries);
+		Board::MOVES_TYPE moves;
+		int solved = 0;
+		int64_t sum = 0;
+		double time = 0;
+		for (int b = 0; solved < nPositions && b < 100 * nPositions; b++)
+		{
+			Board board;
+			if (boards != nullptr && boards->getNBoards() > 0)
+				board.setValues(boards->getBoardValues(b % boards->getNBoards()));
+			Board::BOARD_ELEMENT_TYPE player = Board::BLACK;
+			int passes = 0;
+			while (getEmpties(&board) > nEmpties && passes < 2)
+			{
+				board.validMoves(moves, player);
+				if (moves.size() > 0)
+				{
+					int m = random.getValue(moves.size());
+					board.makeMove(moves[m], moves.getFlips(m), player);
+					passes = 0;
+				}
+				else
+				{
+					passes++;
+				}
+				player = -player;
+			}
+			if (getEmpties(&board) != nEmpties || passes == 2)
+				continue;
+
+			int64_t nodes = solver.getNodes();
+			Watch<double> watch;
+			int score = solver.solve(&board, player);
+			double t = watch.stop();
+			time += t;
+			sum += score;
+			printf("endgame position %d empties %d score %+d nodes %lld time %f s\n", solved, nEmpties, score,
+				(long long)(solver.getNodes() - nodes), t);
+			solved++;
+		}
+		printf("endgame total positions %d empties %d nodes %lld time %f s Mnps %f checksum %lld\n", solved, nEmpties,
+			(long long)solver.getNodes(), time, time > 0 ? solver.getNodes() / time / 1e6 : 0.0, (long long)sum);
+	}
+private:
+	// Najwieksza liczba polruchow (wraz z pasami) od korzenia.
+	static const int MAX_PLY = 128;
+
+	// Granice wyniku pozycji o skrocie key.
+	struct Entry
+	{
+		Board::HASH_TYPE key;
+		signed char lower;
+		signed char upper;
+		Board::INDEX_TYPE move;
+	};
+
+	int size;
+	AlignedArray<Entry> entries;
+	int64_t nodes;
+	Board::MOVES_TYPE moves[MAX_PLY];
+
+	// Wynik pozycji z perspektywy gracza player (fail-soft).
+	// passed - poprzedni gracz spasowal.
+	DEF int negamax(Board *board, Board::BOARD_ELEMENT_TYPE player, int alpha, int beta, bool passed, int ply)
+	{
+		nodes++;
+		int empties = getEmpties(board);
+		if (empties == 0)
+			return getFinalScore(board, player);
+
+		Board::MOVES_TYPE &list = moves[ply];
+		board->validMoves(list, player);
+		int nMoves = list.size();
+		if (nMoves == 0)
+		{
+			if (passed)
+				return getFinalScore(board, player);
+			return -negamax(board, -player, -beta, -alpha, true, ply + 1);
+		}
+
+		Entry *entry = nullptr;
+		Board::HASH_TYPE hash = 0;
+		int ttMove = -1;
+		if (empties >= TT_MIN_EMPTIES)
+		{
+			hash = board->getHash(player);
+			entry = &entries[(int)(hash & (size - 1))];
+			if (entry->key == hash && entry->move >= 0)
+			{
+				if (entry->lower >= beta)
+					return entry->lower;
+				if (entry->upper <= alpha)
+					return entry->upper;
+				if (entry->lower == entry->upper)
+					return entry->lower;
+				alpha = std::max(alpha, (int)entry->lower);
+				beta = std::min(beta, (int)entry->upper);
+				ttMove = list.find(entry->move);
+			}
+		}
+
+		int order[Board::MAX_CH_POS];
+		orderMoves(board, list, player, empties, order, ttMove);
+
+		int alphaBegin = alpha;
+		int best = -MAX_SCORE - 1;
+		int bestIndex = order[0];
+		for (int k = 0; k < nMoves; k++)
+		{
+			int i = order[k];
+			board->makeMove(list[i], list.getFlips(i), player);
+			int score = -negamax(board, -player, -beta, -alpha, false, ply + 1);
+			board->undoMove(list[i], list.getFlips(i), player);
+			if (score > best)
+			{
+				best = score;
+				bestIndex = i;
+				if (score > alpha)
+					alpha = score;
+				if (alpha >= beta)
+					break;
+			}
+		}
+
+		if (entry != nullptr)
+		{
+			if (entry->key != hash || entry->move < 0)
+			{
+				entry->key = hash;
+				entry->lower = -MAX_SCORE;
+				entry->upper = MAX_SCORE;
+			}
+			if (best > alphaBegin)
+				entry->lower = (signed char)best;
+			if (best < beta)
+				entry->upper = (signed char)best;
+			entry->move = list[bestIndex];
+		}
+		return best;
+	}
+
+	// Ustawia w order kolejnosc przeszukiwania ruchow z listy.
+	// first - pozycja ruchu przeszukiwanego jako pierwszy (-1 - brak).
+	DEF void orderMoves(Board *board, Board::MOVES_TYPE &list, Board::BOARD_ELEMENT_TYPE player, int empties, int *order, int first = -1)
+	{
+		int nMoves = list.size();
+		int keys[Board::MAX_CH_POS];
+		Board::BITBOARD_TYPE empty = ~(board->getPawns(Board::BLACK) | board->getPawns(Board::WHITE));
+		for (int i = 0; i < nMoves; i++)
+		{
+			int bit = Board::getBitIndex(list[i]);
+			// ruch w cwiartce o nieparzystej liczbie pustych pol jest lepszy
+			int parity = Board::popCount(empty & getQuadrant(bit)) & 1;
+			if (i == first)
+				keys[i] = -1000;
+			else if (empties >= FASTEST_FIRST_MIN_EMPTIES)
+			{
+				board->makeMove(list[i], list.getFlips(i), player);
+				keys[i] = 2 * Board::popCount(board->getValidMoves(-player)) - parity;
+				board->undoMove(list[i], list.getFlips(i), player);
+			}
+			else
+				keys[i] = -parity;
+			order[i] = i;
+		}
+
+		for (int i = 1; i < nMoves; i++)
+		{
+			int key = order[i];
+			int j = i - 1;
+			while (j >= 0 && keys[order[j]] > keys[key])
+			{
+				order[j + 1] = order[j];
+				j--;
+			}
+			order[j + 1] = key;
+		}
+	}
+
+	// Maska cwiartki planszy zawierajacej pole o numerze bitu bit.
+	DEF static Board::BITBOARD_TYPE getQuadrant(int bit)
+	{
+		static const Board::BITBOARD_TYPE QUADRANTS[4] = { 0x000000000F0F0F0FULL, 0x00000000F0F0F0F0ULL, 0x0F0F0F0F00000000ULL, 0xF0F0F0F000000000ULL };
+		return QUADRANTS[(bit >> 5 & 1) * 2 + (bit >> 2 & 1)];
+	}
+
+	// Roznica pionow gracza player i przeciwnika.
+	DEF static int getFinalScore(Board *board, Board::BOARD_ELEMENT_TYPE player)
+	{
+		Tuple<int, int> counts = board->counts();
+		return player == Board::BLACK ? counts.item1 - counts.item2 : counts.item2 - counts.item1;
+	}
+};
+
+#endif //ENDGAME_SOLVER_H
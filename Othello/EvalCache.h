@@ -0,0 +1,92 @@
+#ifndef EVAL_CACHE_H
+#define EVAL_CACHE_H
+
+#include <stdint.h>
+#include "Header.h"
+#include "Board.h"
+#include "AlignedArray.h"
+
+// Pamiec ocen ruchow jednego gracza w jednym watku (bez synchronizacji).
+// Wpis zajmuje jedna linie pamieci podrecznej i przechowuje oceny kolejnych ruchow
+// z listy poprawnych ruchow pozycji (kolejnosc listy zalezy tylko od pozycji),
+// wiec jedna pozycja kosztuje jedno siegniecie do pamieci. Kluczem jest skrot
+// pozycji z graczem wykonujacym ruch i perspektywa oceny. Kazdy wpis pamieta
+// wersje wag, z ktorymi go obliczono, wiec zmiana wag (setWeights) uniewaznia
+// wszystkie wpisy bez ich czyszczenia. Nowy wpis zastepuje poprzedni w tym samym miejscu.
+class EvalCache
+{
+public:
+	// Liczba ocen w jednym wpisie; oceny dalszych ruchow sa zawsze liczone.
+	static const int MAX_VALUES = 12;
+
+	DEF EvalCache(int nEntries)
+	{
+		size = 1;
+		while (size < nEntries)
+			size <<= 1;
+		entries.resize(size);
+		hits = 0;
+		misses = 0;
+	}
+
+	DEF int getSize() const
+	{
+		return size;
+	}
+
+	// Klucz ocen ruchow w pozycji o skrocie hash, ocenianych z perspektywy perspective.
+	DEF static Board::HASH_TYPE getKey(Board::HASH_TYPE hash, Board::BOARD_ELEMENT_TYPE perspective)
+	{
+		return perspective == Board::WHITE ? hash ^ 0x9e3779b97f4a7c15ULL : hash;
+	}
+
+	// Zwraca oceny pierwszych min(nMoves, MAX_VALUES) ruchow lub nullptr, jesli ich nie ma.
+	DEF const Board::EVALUATION_TYPE *get(Board::HASH_TYPE key, unsigned version, int nMoves)
+	{
+		const Entry &entry = entries[(int)(key & (size - 1))];
+		if (entry.key != key || entry.version != version || entry.nMoves != nMoves)
+		{
+			misses++;
+			return nullptr;
+		}
+		hits++;
+		return entry.values;
+	}
+
+	// Zapamietuje oceny pierwszych min(nMoves, MAX_VALUES) ruchow.
+	DEF void put(Board::HASH_TYPE key, unsigned version, int nMoves, const Board::EVALUATION_TYPE *values)
+	{
+		Entry &entry = entries[(int)(key & (size - 1))];
+		entry.key = key;
+		entry.version = version;
+		entry.nMoves = nMoves;
+		for (int i = 0; i < nMoves && i < MAX_VALUES; i++)
+			entry.values[i] = values[i];
+	}
+
+	DEF int64_t getHits() const
+	{
+		return hits;
+	}
+
+	DEF int64_t getMisses() const
+	{
+		return misses;
+	}
+private:
+	struct Entry
+	{
+		Board::HASH_TYPE key;
+		// Wersja wag gracza; 0 oznacza pusty wpis.
+		unsigned version;
+		int nMoves;
+		Board::EVALUATION_TYPE values[MAX_VALUES];
+	};
+
+	int size;
+	AlignedArray<Entry> entries;
+	int64_t hits;
+	int64_t misses;
+};
+
+#endif //EVAL_CACHE_H
@@ -0,0 +1,170 @@
+#ifndef EXPERT_MOVE_CACHE_H
+#define EXPERT_MOVE_CACHE_H
+
+#include <stdint.h>
+#include <vector>
+#ifndef NOT_TH
+#include <mutex>
+#endif // NOT_TH
+#include "Header.h"
+#include "Board.h"
+#include "Vector.h"
+#include "AlignedArray.h"
+
+// Pamiec podreczna ruchow ekspertow o stalych wagach, wspolna dla wszystkich watkow.
+// Dla pozycji (skrot Zobrista z graczem wykonujacym ruch) zapamietuje zbior najlepiej
+// ocenionych ruchow eksperta, wiec wybor ruchu sposrod remisow (PlayerParams::rand)
+// przebiega tak samo jak bez pamieci, a wyniki gier sie nie zmieniaja.
+// Rozmiar jest staly, a nowy wpis zastepuje poprzedni w tym samym miejscu.
+// Tablica podzielona jest na sekcje chronione osobnymi muteksami.
+class ExpertMoveCache
+{
+public:
+	// Najwieksza liczba zapamietywanych ruchow o rownej ocenie.
+	static const int MAX_MOVES = 6;
+
+	DEF ExpertMoveCache(int nEntries)
+	{
+		size = 1;
+		while (size < nEntries)
+			size <<= 1;
+		entries.resize(size);
+		shards.resize(N_SHARDS);
+		clear();
+	}
+
+	// Usuwa wszystkie wpisy i zeruje statystyki.
+	DEF void clear()
+	{
+		for (int s = 0; s < N_SHARDS; s++)
+		{
+#ifndef NOT_TH
+			std::lock_guard<std::mutex> lock(shards[s].mutex);
+#endif // NOT_TH
+			shards[s].hits = 0;
+			shards[s].misses = 0;
+		}
+		for (int i = 0; i < size; i++)
+			entries[i].expert = -1;
+	}
+
+	// Wypelnia bestMoves zapamietanymi ruchami eksperta. Zwraca false, jesli
+	// pozycji nie ma w pamieci lub wpis nie zgadza sie z lista poprawnych ruchow.
+	DEF bool get(int expert, Board::HASH_TYPE hash, const Board::MOVES_TYPE *validMoves, Vector<Board::INDEX_TYPE, Board::SIZE> &bestMoves)
+	{
+		int index = getIndex(expert, hash);
+		Shard &shard = shards[index & (N_SHARDS - 1)];
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> lock(shard.mutex);
+#endif // NOT_TH
+		Entry &entry = entries[index];
+		if (entry.expert != expert || entry.hash != hash || entry.nValidMoves != validMoves->size())
+		{
+			shard.misses++;
+			return false;
+		}
+		for (int i = 0; i < entry.nMoves; i++)
+		{
+			if (validMoves->find(entry.moves[i]) < 0)
+			{
+				shard.misses++;
+				return false;
+			}
+		}
+
+		bestMoves.clear();
+		for (int i = 0; i < entry.nMoves; i++)
+			bestMoves.add(entry.moves[i]);
+		shard.hits++;
+		return true;
+	}
+
+	// Zapamietuje ruchy eksperta; zbiory wieksze niz MAX_MOVES sa pomijane.
+	DEF void put(int expert, Board::HASH_TYPE hash, const Board::MOVES_TYPE *validMoves, const Vector<Board::INDEX_TYPE, Board::SIZE> &bestMoves)
+	{
+		if (bestMoves.size() > MAX_MOVES)
+			return;
+
+		int index = getIndex(expert, hash);
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> lock(shards[index & (N_SHARDS - 1)].mutex);
+#endif // NOT_TH
+		Entry &entry = entries[index];
+		entry.hash = hash;
+		entry.expert = expert;
+		entry.nValidMoves = (char)validMoves->size();
+		entry.nMoves = (char)bestMoves.size();
+		for (int i = 0; i < bestMoves.size(); i++)
+			entry.moves[i] = bestMoves[i];
+	}
+
+	DEF int64_t getHits()
+	{
+		return getTotal(true);
+	}
+
+	DEF int64_t getMisses()
+	{
+		return getTotal(false);
+	}
+
+	DEF void printStats(FILE *file = stdout)
+	{
+		int64_t hits = getHits();
+		int64_t lookups = hits + getMisses();
+		fprintf(file, "Expert move cache: %d entries, %lld lookups, %lld hits (%.2f%%)\n", size,
+			(long long)lookups, (long long)hits, lookups > 0 ? 100.0 * hits / lookups : 0.0);
+	}
+private:
+	static const int N_SHARDS = 64;
+
+	struct Entry
+	{
+		Board::HASH_TYPE hash;
+		// Numer eksperta (z flaga negacji), -1 dla pustego wpisu.
+		int expert;
+		char nValidMoves;
+		char nMoves;
+		Board::INDEX_TYPE moves[MAX_MOVES];
+	};
+
+	// Muteks i statystyki sekcji, zajmujace osobna linie pamieci podrecznej.
+	struct Shard
+	{
+#ifndef NOT_TH
+		std::mutex mutex;
+#endif // NOT_TH
+		int64_t hits;
+		int64_t misses;
+		char padding[CACHE_LINE_SIZE];
+
+		Shard() : hits(0), misses(0) { }
+
+		Shard(const Shard &other) : hits(other.hits), misses(other.misses) { }
+	};
+
+	int size;
+	std::vector<Entry> entries;
+	std::vector<Shard> shards;
+
+	// Miejsce wpisu - rozni sie dla roznych ekspertow w tej samej pozycji.
+	DEF int getIndex(int expert, Board::HASH_TYPE hash)
+	{
+		return (int)((hash ^ (Board::HASH_TYPE)(expert + 1) * 0x9e3779b97f4a7c15ULL) & (size - 1));
+	}
+
+	DEF int64_t getTotal(bool hits)
+	{
+		int64_t total = 0;
+		for (int s = 0; s < N_SHARDS; s++)
+		{
+#ifndef NOT_TH
+			std::lock_guard<std::mutex> lock(shards[s].mutex);
+#endif // NOT_TH
+			total += hits ? shards[s].hits : shards[s].misses;
+		}
+		return total;
+	}
+};
+
+#endif //EXPERT_MOVE_CACHE_H
@@ -0,0 +1,565 @@
+#ifndef MAILBOX_BOARD_H
+#define MAILBOX_BOARD_H
+
+#include "Header.h"
+#include <iostream>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "Vector.h"
+#include "Tuple.h"
+#include "MoveList.h"
+#include "Zobrist.h"
+#include <assert.h>
+
+#include <limits.h>
+#include <float.h>
+
+// Obsuguje plansz, przechowuje jej stan i przeprowadza na niej wszelkie operacje.
+// Implementacja referencyjna oparta na tablicy 10x10 ze scianami.
+// Uzywana jako Board, gdy zdefiniowano MAILBOX_BOARD.
+class MailboxBoard
+{
+public:
+	// Typ zwracany przez funkcj oceny stanu
+	typedef float EVALUATION_TYPE;
+
+	const static int WORSE_EVAL = INT_MIN;
+	const static int MAX_WEIGHT_VALUE = 1000000;
+	// Typ pojedynczego pola planszy.
+	typedef char BOARD_ELEMENT_TYPE;
+	// Typ indeksu pola.
+	typedef char INDEX_TYPE;
+	// Maksymalna liczba moliwych do wykonania ruchw.
+	const static int MAX_CH_POS = 62;
+	// Maska pol planszy (bit (y-1)*8+(x-1) odpowiada polu o wspolrzednych x, y).
+	typedef uint64_t BITBOARD_TYPE;
+	// Typ skrotu (Zobrista) pozycji.
+	typedef uint64_t HASH_TYPE;
+	// Lista poprawnych ruchow wraz z przejmowanymi pionami.
+	typedef MoveList<INDEX_TYPE, BITBOARD_TYPE, MAX_CH_POS> MOVES_TYPE;
+	// Rozmiar planszy.
+	const static int SIZE = 100;
+	// Liczba moliwych kierunkw ruchu.
+	const static int N_DIR = 8;
+	// Szeroko/wysoko planszy.
+	const static int WIDTH = 10;
+
+	// Warto oznaczjca czarny pion.
+	const static BOARD_ELEMENT_TYPE BLACK = -1;
+	// Warto oznaczjca biay pion.
+	const static BOARD_ELEMENT_TYPE WHITE = 1;
+	// Warto oznaczjca puste pole.
+	const static BOARD_ELEMENT_TYPE EMPTY = 0;
+	// Warto oznaczjca cian.
+	const static BOARD_ELEMENT_TYPE WALL = 2;
+
+	// Tworzy now plansz z pocztkowym ustawieniem pionw.
+	DEF MailboxBoard()
+	{
+		empty();
+	}
+
+	DEF MailboxBoard(const MailboxBoard &board)
+	{
+		copy(&board);
+	}
+
+	DEF MailboxBoard(BOARD_ELEMENT_TYPE *values)
+	{
+		setValues(values);
+	}
+
+	DEF void empty()
+	{
+		memset(board + WIDTH + 1, 0, sizeof(board[0]) * (SIZE - 2 * (WIDTH + 1)));
+
+		for(int i = 0; i < 9; i++)
+		{
+			board[getIndex(0, i)] = WALL;
+			board[getIndex(i, WIDTH - 1)] = WALL;
+			board[getIndex(WIDTH - 1, i + 1)] = WALL;
+			board[getIndex(i + 1, 0)] = WALL;
+		}
+
+		board[getIndex(4, 4)] = WHITE;
+		board[getIndex(5, 5)] = WHITE;
+
+		board[getIndex(4, 5)] = BLACK;
+		board[getIndex(5, 4)] = BLACK;
+
+		nPawns = 4;
+		hash = computeHash();
+
+		getDirections(directions);
+	}
+
+	DEF void setValues(BOARD_ELEMENT_TYPE *values)
+	{
+		memset(board + WIDTH + 1, 0, sizeof(board[0]) * (SIZE - 2 * (WIDTH + 1)));
+
+		for (int i = 0; i < 9; i++)
+		{
+			board[getIndex(0, i)] = WALL;
+			board[getIndex(i, WIDTH - 1)] = WALL;
+			board[getIndex(WIDTH - 1, i + 1)] = WALL;
+			board[getIndex(i + 1, 0)] = WALL;
+		}
+
+		int count = 0;
+
+		for (int i = 0; i < 64; i++)
+		{
+			int x = i % 8 + 1;
+			int y = i / 8 + 1;
+			board[getIndex(x, y)] = values[i];
+			if (values[i] != EMPTY)
+                count++;
+		}
+
+		this->nPawns = count;
+		hash = computeHash();
+
+		getDirections(directions);
+	}
+
+	DEF void copy(const MailboxBoard *board)
+	{
+		memcpy(this, board, sizeof(MailboxBoard));
+	}
+
+	// Zwraca element na planszy znajdujcy si na wskazanej pozycji.
+	DEF BOARD_ELEMENT_TYPE getValue(int x, int y)
+	{
+		return board[getIndex(x, y)];
+	}
+
+	// Zwraca element na planszy znajdujcy si pod wskazanym indeksem.
+	DEF BOARD_ELEMENT_TYPE getValue(INDEX_TYPE index)
+	{
+		/*if (board[index] == WALL)
+			return WALL;*/
+		return board[index];
+	}
+
+	// Ustawia warto elementu na planszy znajdujgo si na wskazanej pozycji.
+	// Uaktualnia skrot pozycji jak setValue(index, value).
+	DEF void setValue(int x, int y, BOARD_ELEMENT_TYPE value)
+	{
+		setValue(getIndex(x, y), value);
+	}
+
+	// Ustawia warto elementu na planszy znajdujgo si pod wskazanym indeksem.
+	// Uaktualnia skrot pozycji, wiec index musi wskazywac pole planszy (nie sciane).
+	DEF void setValue(INDEX_TYPE index, BOARD_ELEMENT_TYPE value)
+	{
+		BOARD_ELEMENT_TYPE old = board[index];
+		if (old == BLACK || old == WHITE)
+			hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(old)][getBitIndex(index)];
+		if (value == BLACK || value == WHITE)
+			hash ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(value)][getBitIndex(index)];
+		board[index] = value;
+	}
+
+	// Zwraca indeks odpowiadajcy wskazanej pozycji.
+	DEF static INDEX_TYPE getIndex(INDEX_TYPE x, INDEX_TYPE y)
+	{
+		return y * WIDTH + x;
+	}
+
+	// Zwraca wsprzdn X pola.
+	DEF static INDEX_TYPE getX(INDEX_TYPE move)
+	{
+		return move % WIDTH;
+	}
+
+	// Zwraca wsprzdn Y pola.
+	DEF static INDEX_TYPE getY(INDEX_TYPE move)
+	{
+		return move / WIDTH;
+	}
+
+	DEF static void getMoveX(INDEX_TYPE move, INDEX_TYPE *x)
+	{
+		*x = move % WIDTH;
+		if (*x > 1)
+			*x -= WIDTH;
+		else if (*x < -1)
+			*x += WIDTH;
+	}
+
+	DEF static void getMoveXY(INDEX_TYPE move, INDEX_TYPE *x, INDEX_TYPE *y)
+	{
+		getMoveX(move, x);
+		*y = (move - *x) / WIDTH;
+	}
+
+	// Okrela, czy na podanym polu jest moliwy ruch.
+	DEF static bool isPlayable(int move)
+	{
+		int x = getX(move);
+		int y = getY(move);
+		if (x < 1 || x >= (WIDTH - 1))
+			return false;
+
+		if (y < 1 || y >= (WIDTH - 1))
+			return false;
+
+		return true;
+	}
+
+	// Umieszcza na liscie poprawne w danej chwili ruchy (w kolejnosci indeksow pol).
+	DEF void validMoves(MOVES_TYPE &moves, BOARD_ELEMENT_TYPE player)
+	{
+		moves.clear();
+
+		for(int y = 1; y < WIDTH - 1; y++)
+		{
+			int endIndex = getIndex(WIDTH - 1, y);
+			for(INDEX_TYPE index = getIndex(1, y); index < endIndex; index++)
+			{
+				if (getValue(index) == EMPTY && isMoveValid(index, player))
+				{
+					simulateMove(&positions, index, player);
+					BITBOARD_TYPE flips = 0;
+					for (int i = 0; i < positions.size() - 1; i++)
+						flips |= getBit(positions[i]);
+					moves.add(index, flips);
+				}
+			}
+		}
+	}
+
+	// Zwraca kolekcj z kierunkami.
+	DEF const Vector<INDEX_TYPE, N_DIR>& getDirections()
+	{
+		return directions;
+	}
+
+	// Uzupenia kolekcj moliwymi kierunkami.
+	DEF static void getDirections(Vector<INDEX_TYPE, N_DIR> &dir)
+	{
+		dir.clear();
+		dir.add(-WIDTH - 1);
+		dir.add(-WIDTH);
+		dir.add(-WIDTH + 1);
+		dir.add(-1);
+		dir.add(1);
+		dir.add(WIDTH - 1);
+		dir.add(WIDTH);
+		dir.add(WIDTH + 1);
+	}
+
+	// Wykonuje ruch umieszczajc na planszy pod wskazanym indeksem pion aktualnego gracza.
+	DEF void makeMove(INDEX_TYPE index, BOARD_ELEMENT_TYPE player/*, bool invertion*/)
+	{
+		positions.clear();
+		simulateMove(&positions, index, player);
+		makeMovePos(&positions, player);
+	}
+
+	// Wykonuje ruch umieszczajc na planszy pod wskazanym indeksem pion aktualnego gracza.
+	// positions - indeksy pl, na ktrych pojawiaj si piony gracza
+	template <typename T>
+	DEF void makeMovePos(const T *positions, BOARD_ELEMENT_TYPE player/*, bool inevertion*/)
+	{
+		performMove(positions, player);
+
+		/*if (inevertion)
+			invert();*/
+
+        nPawns++;
+	}
+
+	// Wykonuje ruch, ktorego przejmowane piony zostaly juz wyznaczone przez validMoves.
+	DEF void makeMove(INDEX_TYPE index, BITBOARD_TYPE flips, BOARD_ELEMENT_TYPE player)
+	{
+		getPositions(&positions, index, flips);
+		makeMovePos(&positions, player);
+	}
+
+	// Cofa ruch wykonany przez makeMove(index, flips, player).
+	DEF void undoMove(INDEX_TYPE index, BITBOARD_TYPE flips, BOARD_ELEMENT_TYPE player)
+	{
+		getPositions(&positions, index, flips);
+		performMove(&positions, -player);
+		setValue(index, EMPTY);
+
+		nPawns--;
+	}
+
+	// Wypelnia kolekcje indeksami pol, na ktorych pojawia sie piony gracza,
+	// na podstawie maski przejmowanych pionow zwroconej przez validMoves.
+	template <typename T>
+	DEF static void getPositions(T *positions, INDEX_TYPE index, BITBOARD_TYPE flips)
+	{
+		positions->clear();
+		for (int bit = 0; bit < 64; bit++)
+		{
+			if (flips & ((BITBOARD_TYPE)1 << bit))
+				positions->add(getIndex(bit % 8 + 1, bit / 8 + 1));
+		}
+		positions->add(index);
+	}
+
+	DEF static BITBOARD_TYPE getBit(INDEX_TYPE index)
+	{
+		return (BITBOARD_TYPE)1 << getBitIndex(index);
+	}
+
+	// Zamienia indeks pola na numer bitu w masce.
+	DEF static int getBitIndex(INDEX_TYPE index)
+	{
+		return (getY(index) - 1) * 8 + getX(index) - 1;
+	}
+
+	// Zamienia numer bitu w masce na indeks pola.
+	DEF static INDEX_TYPE getFieldIndex(int bitIndex)
+	{
+		return getIndex(bitIndex % 8 + 1, bitIndex / 8 + 1);
+	}
+
+	// Zwraca numer najmlodszego ustawionego bitu (value != 0).
+	DEF static int bitScanForward(BITBOARD_TYPE value)
+	{
+		int bit = 0;
+		while (!(value & 1))
+		{
+			value >>= 1;
+			bit++;
+		}
+		return bit;
+	}
+
+	// Zwraca skrot Zobrista pozycji z uwzglednieniem gracza wykonujacego ruch.
+	DEF HASH_TYPE getHash(BOARD_ELEMENT_TYPE player)
+	{
+		return player == WHITE ? hash ^ ZobristTables<HASH_TYPE>::SIDE : hash;
+	}
+
+	// Wyznacza skrot pionow od nowa (musi byc rowny getHash(BLACK)).
+	DEF HASH_TYPE computeHash()
+	{
+		HASH_TYPE result = 0;
+		for (int bit = 0; bit < 64; bit++)
+		{
+			BOARD_ELEMENT_TYPE value = getValue(getFieldIndex(bit));
+			if (value == BLACK || value == WHITE)
+				result ^= ZobristTables<HASH_TYPE>::KEYS[getColorIndex(value)][bit];
+		}
+		return result;
+	}
+
+	// Zwraca maske pionow gracza o wskazanym kolorze.
+	DEF BITBOARD_TYPE getPawns(BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE result = 0;
+		for (int bit = 0; bit < 64; bit++)
+		{
+			if (getValue(getFieldIndex(bit)) == player)
+				result |= (BITBOARD_TYPE)1 << bit;
+		}
+		return result;
+	}
+
+	// Zwraca maske wszystkich poprawnych ruchow gracza.
+	DEF BITBOARD_TYPE getValidMoves(BOARD_ELEMENT_TYPE player)
+	{
+		BITBOARD_TYPE result = 0;
+		for (int bit = 0; bit < 64; bit++)
+		{
+			INDEX_TYPE index = getFieldIndex(bit);
+			if (getValue(index) == EMPTY && isMoveValid(index, player))
+				result |= (BITBOARD_TYPE)1 << bit;
+		}
+		return result;
+	}
+
+	DEF static int popCount(BITBOARD_TYPE value)
+	{
+		int result = 0;
+		for (; value; value &= value - 1)
+			result++;
+		return result;
+	}
+
+	// Wypenia kolekcj indeksami pl, na ktrych pojawi si piony gracza po wykonaniu wskazanego ruchu.
+	template <typename T>
+	DEF void simulateMove(T *positions, INDEX_TYPE index, BOARD_ELEMENT_TYPE player)
+	{
+		positions->clear();
+		for (int i = 0; i < directions.size(); i++)
+		{
+			INDEX_TYPE dir = directions[i];
+			INDEX_TYPE pos = index + dir;
+
+			while (getValue(pos) == -player)
+			{
+				pos += dir;
+			}
+
+			if (getValue(pos) == player)
+			{
+				pos -= dir;
+				while (getValue(pos) == -player)
+				{
+					positions->add(pos);
+					pos -= dir;
+				}
+			}
+		}
+
+		positions->add(index);
+	}
+
+	// Drukuje plansz w konsoli.
+	DEF void print()
+	{
+		printf("\n  ");
+		for(int x = 0; x < 10; x++)
+		{
+			printf(" %d ", x);
+		}
+		printf("\n");
+
+		for(int y = 0; y < 10; y++)
+		{
+			printf("\n%d ", y);
+			for(int x = 0; x < 10; x++)
+			{
+				printf(" %s ", getChar(board[getIndex(x, y)]));
+			}
+			printf("\n");
+		}
+		printf("\n");
+	}
+
+	DEF Tuple<int, int> counts()
+	{
+        int count1 = 0;
+		int count2 = 0;
+		for(int y = 1; y < WIDTH - 1; y++)
+		{
+			INDEX_TYPE index = getIndex(1, y);
+			for(int x = 1; x < WIDTH - 1; x++)
+			{
+				BOARD_ELEMENT_TYPE value = board[index];
+
+				if (value == BLACK)
+					count1++;
+				if (value == WHITE)
+					count2++;
+
+				index++;
+			}
+		}
+		return Tuple<int, int>(count1, count2);
+	}
+
+	// Zwraca rezultat rozgrywki w postaci iloci pionw obu graczy.
+	DEF Tuple<EVALUATION_TYPE, EVALUATION_TYPE> result()
+	{
+		int count1 = 0;
+		int count2 = 0;
+		for(int y = 1; y < WIDTH - 1; y++)
+		{
+			INDEX_TYPE index = getIndex(1, y);
+			for(int x = 1; x < WIDTH - 1; x++)
+			{
+				BOARD_ELEMENT_TYPE value = board[index];
+
+				if (value == BLACK)
+					count1++;
+				if (value == WHITE)
+					count2++;
+
+				index++;
+			}
+		}
+
+		EVALUATION_TYPE result1 = 0;
+		EVALUATION_TYPE result2 = 0;
+		if (count1 == count2)
+			result1 = result2 = 0.5;
+		else if (count1 > count2)
+			result1 = 1;
+		else
+			result2 = 1;
+
+		return Tuple<EVALUATION_TYPE, EVALUATION_TYPE>(result1, result2);
+	}
+
+	// Wykonuje wskazany ruch poprzez umieszczenie pionw gracza na planszy.
+	template <typename T>
+	DEF void performMove(const T *positions, BOARD_ELEMENT_TYPE player)
+	{
+		for(int i = 0; i < positions->size(); i++)
+		{
+			setValue(positions[0][i], player);
+		}
+	}
+
+	DEF int getNPawns()
+	{
+        return nPawns;
+	}
+private:
+	// Tablica z elementami planszy.
+	BOARD_ELEMENT_TYPE board[SIZE];
+	// Liczba pionw na planszy.
+	int nPawns;
+	// Skrot Zobrista pionow, uaktualniany przy kazdej zmianie planszy.
+	HASH_TYPE hash;
+	// Kolekcja z indeksami kierunkw.
+	Vector<INDEX_TYPE, N_DIR> directions;
+
+	Vector<BOARD_ELEMENT_TYPE, MAX_CH_POS> positions;
+
+	DEF static int getColorIndex(BOARD_ELEMENT_TYPE player)
+	{
+		return (player + 1) >> 1;
+	}
+
+	DEF const char * getChar(BOARD_ELEMENT_TYPE value)
+	{
+		switch (value)
+		{
+		case WHITE:
+			return "X";
+		case BLACK:
+			return "O";
+		case WALL:
+		case -WALL:
+			return "+";
+		case EMPTY:
+			return " ";
+		default:
+			return "?";
+		}
+	}
+
+	// Sprawdza, czy wskazany ruch jest poprawny.
+	DEF bool isMoveValid(INDEX_TYPE index, BOARD_ELEMENT_TYPE player)
+	{
+		for (int i = 0; i < directions.size(); i++)
+		{
+			int dir = directions[i];
+			int pos = index + dir;
+
+			while (getValue(pos) == -player)
+			{
+				pos += dir;
+			}
+
+			if (getValue(pos) == player && getValue(pos - dir) == -player)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+#endif //MAILBOX_BOARD_H
+
@@ -0,0 +1,733 @@
+#ifndef MCTS_PLAYER_H
+#define MCTS_PLAYER_H
+
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifndef NOT_TH
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#endif // NOT_TH
+#include "Header.h"
+#include "Board.h"
+#include "PlayerParams.h"
+#include "OthelloPlayer.h"
+#include "AnyLoader.h"
+#include "Random.h"
+#include "Watch.h"
+
+#ifndef NOT_TH
+typedef std::atomic<int> MCTS_COUNTER;
+#else
+typedef int MCTS_COUNTER;
+#endif // NOT_TH
+
+// Wezel drzewa MCTS. Statystyki zmieniane sa przez watki bez blokad (operacje atomowe),
+// a dzieci wezla zajmuja ciagly fragment puli wezlow.
+struct MctsNode
+{
+	// Stan rozwiniecia wezla.
+	enum State
+	{
+		LEAF,
+		EXPANDING,
+		EXPANDED
+	};
+
+	// Piony przejmowane ruchem prowadzacym do wezla.
+	Board::BITBOARD_TYPE flips;
+	// Skrot pozycji wezla z graczem wykonujacym ruch.
+	Board::HASH_TYPE hash;
+	// Prawdopodobienstwo ruchu wedlug gracza oceniajacego (PUCT).
+	float prior;
+	MCTS_COUNTER visits;
+	// Wygrane gracza, ktory wykonal ruch prowadzacy do wezla, w polowkach punktu.
+	MCTS_COUNTER wins;
+	// Liczba nieukonczonych symulacji przechodzacych przez wezel.
+	MCTS_COUNTER virtualLoss;
+	MCTS_COUNTER state;
+	int firstChild;
+	int nChildren;
+	// Ruch prowadzacy do wezla (-1 - pas).
+	Board::INDEX_TYPE move;
+	// Gracz wykonujacy ruch w pozycji wezla.
+	Board::BOARD_ELEMENT_TYPE player;
+	// Koniec gry.
+	bool terminal;
+};
+
+// Stan jednego watku symulacji: parametry gracza rozgrywajacego symulacje,
+// kopia planszy i sciezka od korzenia.
+struct MctsWorker
+{
+	// Najwieksza liczba polruchow (wraz z pasami) od korzenia.
+	static const int MAX_PATH = 128;
+
+	MctsWorker(PlayerParams *params) : params(params), playouts(0) { }
+
+	PlayerParams *params;
+	GameData data;
+	Random<int> rand;
+	Random<float> randFloat;
+	Board board;
+	Board::MOVES_TYPE moves;
+	int path[MAX_PATH];
+	Board::EVALUATION_TYPE values[Board::MAX_CH_POS];
+	// Symulacje wykonane w ostatnim przeszukiwaniu.
+	int64_t playouts;
+};
+
+// Stan gracza MctsPlayer w jednej grze: pula wezlow drzewa przydzielona z gory,
+// korzen zachowywany miedzy ruchami oraz stan watkow symulacji. Watki pomocnicze
+// (workers[1..]) tworzone sa przy pierwszym ruchu i czekaja na kolejne ruchy.
+class MctsPlayerParams : public PlayerParams
+{
+public:
+	// params - parametry opakowanego gracza (watku glownego),
+	// workerParams - parametry opakowanego gracza dla watkow pomocniczych.
+	DEF MctsPlayerParams(int seed, PlayerParams *params, const std::vector<PlayerParams *> &workerParams, int nNodes) :
+		PlayerParams(seed), params(params)
+	{
+		capacity = std::max(nNodes, 2 * Board::MAX_CH_POS);
+		nodes = new MctsNode[capacity];
+		next = 0;
+		root = -1;
+		started = 0;
+#ifndef NOT_TH
+		searchBoard = nullptr;
+		generation = 0;
+		nRunning = 0;
+		stopping = false;
+#endif // NOT_TH
+		workers.push_back(new MctsWorker(params));
+		for (size_t i = 0; i < workerParams.size(); i++)
+			workers.push_back(new MctsWorker(workerParams[i]));
+	}
+
+	DEF ~MctsPlayerParams()
+	{
+#ifndef NOT_TH
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wakeUp.notify_all();
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i]->join();
+			delete threads[i];
+		}
+#endif // NOT_TH
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			delete workers[i]->params;
+			delete workers[i];
+		}
+		delete[] nodes;
+	}
+
+	// Nowa gra zaczyna sie od pustego drzewa, wiec wynik nie zalezy od poprzednich gier.
+	DEF void setSeed(int seed)
+	{
+		PlayerParams::setSeed(seed);
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i]->params->setSeed(rand.rand());
+		root = -1;
+	}
+
+	DEF void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		PlayerParams::addEvalCacheStats(hits, misses);
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i]->params->addEvalCacheStats(hits, misses);
+	}
+
+	// Parametry opakowanego gracza (watku glownego).
+	PlayerParams *params;
+	std::vector<MctsWorker *> workers;
+	MctsNode *nodes;
+	int capacity;
+	// Pierwszy wolny wezel puli.
+	MCTS_COUNTER next;
+	// Korzen drzewa: po wyborze ruchu wezel tego ruchu (-1 - brak drzewa).
+	int root;
+	// Symulacje rozpoczete w biezacym przeszukiwaniu.
+	MCTS_COUNTER started;
+	Watch<double> watch;
+#ifndef NOT_TH
+	// Watki pomocnicze; watek i wykonuje symulacje robotnika workers[i + 1].
+	std::vector<std::thread *> threads;
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable done;
+	// Plansza korzenia biezacego przeszukiwania.
+	Board *searchBoard;
+	// Numer biezacego przeszukiwania.
+	unsigned generation;
+	// Liczba watkow pomocniczych, ktore nie zakonczyly biezacego przeszukiwania.
+	int nRunning;
+	bool stopping;
+#endif // NOT_TH
+};
+
+// Gracz wybierajacy ruch przeszukiwaniem drzewa metoda Monte Carlo (MCTS).
+// Symulacje rozgrywa do konca gry opakowany gracz (np. N-krotkowy lub WPC),
+// wykonujac z prawdopodobienstwem randomFreq ruch losowy (1 - symulacje losowe).
+// Ruchy w drzewie wybierane sa wedlug UCT albo, gdy puct jest wlaczone, wedlug PUCT
+// z prawdopodobienstwami ruchow (softmax ocen evaluateMove z temperatura temperature)
+// gracza CpuPlayer wskazanego przez opakowanego gracza (getEvaluator).
+// Wezel jest rozwijany przy drugiej symulacji przez niego przechodzacej.
+// Wezly pochodza z przydzielonej z gory puli w parametrach gry, wiec symulacje
+// nie przydzielaja pamieci. Poddrzewo wybranego ruchu jest zachowywane: w kolejnym
+// ruchu korzeniem staje sie wezel pozycji po ruchu przeciwnika. Pula nie jest
+// zwalniana czesciowo - gdy zajeta jest ponad polowa, drzewo budowane jest od nowa,
+// a gdy zabraknie wezlow, symulacje koncza sie w lisciach bez ich rozwijania.
+// Przeszukiwanie konczy sie po maxPlayouts symulacjach lub po maxTime sekundach
+// (0 - bez limitu). Wybierany jest ruch najczesciej odwiedzany.
+// Dla nThreads > 1 symulacje wykonuje rownolegle nThreads watkow na wspolnym drzewie;
+// wirtualna porazka (virtual loss) zniecheca watki do wybierania tej samej sciezki.
+// Wynik przeszukiwania rownoleglego zalezy od przeplotu watkow. Watki pomocnicze naleza
+// do parametrow gry (poza pula ThreadPool, ktora moze wykonywac gre wywolujaca getMove)
+// i sa budzone przy kazdym ruchu, wiec ruch nie tworzy watkow ani nie przydziela pamieci.
+class MctsPlayer : public OthelloPlayer
+{
+public:
+	// Domyslny rozmiar puli wezlow.
+	static const int DEFAULT_NODES = 1 << 18;
+
+	// player - gracz rozgrywajacy symulacje, usuwany wraz z obiektem.
+	DEF MctsPlayer(OthelloPlayer *player, int64_t maxPlayouts, int nThreads = 1, double maxTime = 0, int nNodes = DEFAULT_NODES,
+		float c = 1.0f, float randomFreq = 0, bool puct = false, float temperature = 1.0f)
+		: OthelloPlayer()
+	{
+		this->player = player;
+		this->maxPlayouts = maxPlayouts;
+		this->nThreads = std::max(nThreads, 1);
+		this->maxTime = maxTime;
+		this->nNodes = nNodes;
+		this->c = c;
+		this->randomFreq = randomFreq;
+		this->puct = puct;
+		this->temperature = temperature > 0 ? temperature : 1.0f;
+	}
+
+	DEF ~MctsPlayer()
+	{
+		delete player;
+	}
+
+	DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *p, GameData *data)
+	{
+		MctsPlayerParams *par = static_cast<MctsPlayerParams *>(p);
+		if (validMoves->size() == 1)
+		{
+			par->root = -1;
+			return (*validMoves)[0];
+		}
+
+		PHASE_TIMER(EVALUATION);
+		MctsWorker *main = par->workers[0];
+		int root = findRoot(board, playerColor, par);
+		if (root < 0)
+		{
+			par->next = 1;
+			root = 0;
+			initNode(par->nodes[0], -1, 0, board->getHash(playerColor), playerColor, 1.0f);
+		}
+		par->root = root;
+		if (par->nodes[root].state != MctsNode::EXPANDED)
+		{
+			main->board.copy(board);
+			expand(root, par, main);
+		}
+
+		par->started = 0;
+		par->watch.start();
+		for (size_t t = 0; t < par->workers.size(); t++)
+		{
+			par->workers[t]->rand = Random<int>(par->rand.rand());
+			par->workers[t]->randFloat = Random<float>(par->rand.rand());
+			par->workers[t]->playouts = 0;
+		}
+#ifndef NOT_TH
+		while (par->threads.size() + 1 < par->workers.size())
+			par->threads.push_back(new std::thread(&MctsPlayer::runHelper, this, par, (int)par->threads.size() + 1, par->generation));
+		{
+			std::lock_guard<std::mutex> lock(par->mutex);
+			par->searchBoard = board;
+			par->nRunning = (int)par->threads.size();
+			par->generation++;
+		}
+		par->wakeUp.notify_all();
+		runPlayouts(board, par, main);
+		{
+			std::unique_lock<std::mutex> lock(par->mutex);
+			par->done.wait(lock, [par] { return par->nRunning == 0; });
+		}
+#else
+		runPlayouts(board, par, main);
+#endif // NOT_TH
+
+		MctsNode &node = par->nodes[root];
+		int bestVisits = -1;
+		par->bestMoves.clear();
+		for (int i = 0; i < node.nChildren; i++)
+		{
+			int visits = par->nodes[node.firstChild + i].visits;
+			if (visits > bestVisits)
+			{
+				bestVisits = visits;
+				par->bestMoves.clear();
+			}
+			if (visits == bestVisits)
+				par->bestMoves.add(par->nodes[node.firstChild + i].move);
+		}
+
+		Board::INDEX_TYPE move;
+		switch (par->bestMoves.size())
+		{
+		case 0:
+			printf("Invalid game state - player has no moves.\n");
+			exit(0);
+			return -1;
+		case 1:
+			move = par->bestMoves[0];
+			break;
+		default:
+#ifdef MIN_MOVE
+			move = 101;
+			for (int i = 0; i < par->bestMoves.size(); i++)
+				if (move > par->bestMoves[i])
+					move = par->bestMoves[i];
+#else
+			move = par->bestMoves[par->rand.getValue(par->bestMoves.size())];
+#endif
+			break;
+		}
+
+		for (int i = 0; i < node.nChildren; i++)
+		{
+			if (par->nodes[node.firstChild + i].move == move)
+				par->root = node.firstChild + i;
+		}
+		return move;
+	}
+
+	DEF bool isNegated(Board *board)
+	{
+		return player->isNegated(board);
+	}
+
+	DEF int getNWeights()
+	{
+		return player->getNWeights();
+	}
+
+	DEF void getWeights(Board::EVALUATION_TYPE *weights)
+	{
+		player->getWeights(weights);
+	}
+
+	DEF void setWeights(const Board::EVALUATION_TYPE *weights)
+	{
+		player->setWeights(weights);
+	}
+
+	DEF PlayerParams *getPlayerParams(int seed)
+	{
+		Random<int> random(seed);
+		PlayerParams *params = player->getPlayerParams(random.rand());
+		std::vector<PlayerParams *> workerParams;
+		for (int t = 1; t < nThreads; t++)
+			workerParams.push_back(player->getPlayerParams(random.rand()));
+		return new MctsPlayerParams(seed, params, workerParams, nNodes);
+	}
+
+	DEF void setEvalCache(int nEntries)
+	{
+		player->setEvalCache(nEntries);
+	}
+
+	DEF void setOpeningBook(const OpeningBook *book, int minGames)
+	{
+		player->setOpeningBook(book, minGames);
+	}
+
+	// Liczba symulacji wykonanych przez wszystkie watki w ostatnim przeszukiwaniu.
+	DEF static int64_t getPlayouts(PlayerParams *p)
+	{
+		MctsPlayerParams *par = static_cast<MctsPlayerParams *>(p);
+		int64_t playouts = 0;
+		for (size_t i = 0; i < par->workers.size(); i++)
+			playouts += par->workers[i]->playouts;
+		return playouts;
+	}
+
+	// Wybiera ruchy w pozycjach srodka gry (nPlies losowych ruchow od plansz z pliku)
+	// kolejno na 1, 2, 4, ... maxThreads watkach i wypisuje liczbe symulacji na sekunde.
+	// Zwraca liczbe symulacji na sekunde dla maxThreads watkow.
+	static double benchmark(const std::string &playerFile, int64_t playouts, int maxThreads, BoardLoader *boards, int nPositions, int nPlies, int seed,
+		float randomFreq = 0, bool puct = false)
+	{
+		std::vector<Board> positions;
+		std::vector<Board::BOARD_ELEMENT_TYPE> colors;
+		Random<int> random(seed);
+		Board::MOVES_TYPE moves;
+		for (int b = 0; (int)positions.size() < nPositions && b < 100 * nPositions; b++)
+		{
+			Board board;
+			if (boards != nullptr && boards->getNBoards() > 0)
+				board.setValues(boards->getBoardValues(b % boards->getNBoards()));
+			Board::BOARD_ELEMENT_TYPE color = Board::BLACK;
+			for (int i = 0; i < nPlies; i++, color = -color)
+			{
+				board.validMoves(moves, color);
+				if (moves.size() > 0)
+				{
+					int m = random.getValue(moves.size());
+					board.makeMove(moves[m], moves.getFlips(m), color);
+				}
+			}
+			board.validMoves(moves, color);
+			if (moves.size() > 1)
+			{
+				positions.push_back(board);
+				colors.push_back(color);
+			}
+		}
+
+		double rate = 0;
+		for (int threads = 1; ; threads = std::min(2 * threads, maxThreads))
+		{
+			OthelloPlayer *rollout = OthelloPlayer::getPlayer(playerFile, seed, false);
+			if (rollout == nullptr)
+				return 0;
+			MctsPlayer player(rollout, playouts, threads, 0, DEFAULT_NODES, 1.0f, randomFreq, puct);
+			PlayerParams *params = player.getPlayerParams(seed);
+			GameData data;
+			int64_t total = 0;
+			int checksum = 0;
+			Watch<double> watch;
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				// kazda pozycja z nowym drzewem
+				params->setSeed(seed + (int)i);
+				Board board(positions[i]);
+				board.validMoves(moves, colors[i]);
+				checksum += player.getMove(&board, &moves, colors[i], false, params, &data);
+				total += getPlayouts(params);
+			}
+			double time = watch.stop();
+			rate = time > 0 ? total / time : 0.0;
+			printf("mcts threads %d positions %d time %f s playouts %lld playouts/s %f checksum %d\n", threads, (int)positions.size(),
+				time, (long long)total, rate, checksum);
+			fflush(stdout);
+			delete params;
+			if (threads >= maxThreads)
+				break;
+		}
+		return rate;
+	}
+private:
+	// Pierwsza ocena nieodwiedzonego ruchu w PUCT.
+	static constexpr float FIRST_PLAY_VALUE = 0.5f;
+
+	OthelloPlayer *player;
+	int64_t maxPlayouts;
+	int nThreads;
+	double maxTime;
+	int nNodes;
+	float c;
+	float randomFreq;
+	bool puct;
+	float temperature;
+
+	DEF static void initNode(MctsNode &node, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::HASH_TYPE hash, Board::BOARD_ELEMENT_TYPE player, float prior)
+	{
+		node.flips = flips;
+		node.hash = hash;
+		node.prior = prior;
+		node.visits = 0;
+		node.wins = 0;
+		node.virtualLoss = 0;
+		node.state = MctsNode::LEAF;
+		node.firstChild = -1;
+		node.nChildren = 0;
+		node.move = move;
+		node.player = player;
+		node.terminal = false;
+	}
+
+	// Wezel pozycji board z graczem player w drzewie poprzedniego ruchu (-1 - brak).
+	// Korzen poprzedniego ruchu wskazuje wezel wybranego ruchu, wiec szukana pozycja
+	// jest jednym z jego dzieci (ruch przeciwnika lub pas).
+	DEF int findRoot(Board *board, Board::BOARD_ELEMENT_TYPE player, MctsPlayerParams *par)
+	{
+		if (par->root < 0 || par->next > par->capacity / 2)
+			return -1;
+		Board::HASH_TYPE hash = board->getHash(player);
+		MctsNode &node = par->nodes[par->root];
+		if (node.hash == hash && node.player == player)
+			return par->root;
+		if (node.state != MctsNode::EXPANDED)
+			return -1;
+		for (int i = 0; i < node.nChildren; i++)
+		{
+			MctsNode &child = par->nodes[node.firstChild + i];
+			if (child.hash == hash && child.player == player)
+				return node.firstChild + i;
+		}
+		return -1;
+	}
+
+#ifndef NOT_TH
+	// Petla watku pomocniczego: czeka na kolejne przeszukiwanie i wykonuje symulacje
+	// robotnika workers[t] na planszy korzenia.
+	DEF void runHelper(MctsPlayerParams *par, int t, unsigned seen)
+	{
+		std::unique_lock<std::mutex> lock(par->mutex);
+		while (true)
+		{
+			par->wakeUp.wait(lock, [par, seen] { return par->stopping || par->generation != seen; });
+			if (par->stopping)
+				return;
+			seen = par->generation;
+			Board *board = par->searchBoard;
+			lock.unlock();
+
+			runPlayouts(board, par, par->workers[t]);
+
+			lock.lock();
+			if (--par->nRunning == 0)
+				par->done.notify_all();
+		}
+	}
+#endif // NOT_TH
+
+	// Symulacje jednego watku do wyczerpania limitu.
+	DEF void runPlayouts(Board *board, MctsPlayerParams *par, MctsWorker *worker)
+	{
+		while (true)
+		{
+			if (maxPlayouts > 0 && par->started++ >= maxPlayouts)
+				break;
+			if (maxTime > 0 && par->watch.current() >= maxTime)
+				break;
+			if (maxPlayouts <= 0 && maxTime <= 0)
+				break;
+			worker->board.copy(board);
+			playout(par, worker);
+			worker->playouts++;
+		}
+	}
+
+	// Jedna symulacja: wybor sciezki w drzewie, rozwiniecie liscia, rozgrywka do konca
+	// gry i aktualizacja statystyk wezlow sciezki.
+	DEF void playout(MctsPlayerParams *par, MctsWorker *worker)
+	{
+		int node = par->root;
+		int length = 0;
+		worker->path[length++] = node;
+		par->nodes[node].virtualLoss++;
+		while (length < MctsWorker::MAX_PATH)
+		{
+			// pola wezla sa ustalone dopiero w stanie EXPANDED
+			MctsNode &current = par->nodes[node];
+			if (current.state != MctsNode::EXPANDED && (current.visits < 1 || !expand(node, par, worker)))
+				break;
+			if (current.terminal)
+				break;
+
+			node = select(current, par);
+			MctsNode &child = par->nodes[node];
+			if (child.move >= 0)
+				worker->board.makeMove(child.move, child.flips, current.player);
+			worker->path[length++] = node;
+			child.virtualLoss++;
+		}
+
+		Board::BOARD_ELEMENT_TYPE winner = rollout(worker, par->nodes[node].player);
+		for (int i = 0; i < length; i++)
+		{
+			MctsNode &current = par->nodes[worker->path[i]];
+			if (i > 0)
+			{
+				Board::BOARD_ELEMENT_TYPE mover = par->nodes[worker->path[i - 1]].player;
+				current.wins += winner == mover ? 2 : winner == Board::EMPTY ? 1 : 0;
+			}
+			current.visits++;
+			current.virtualLoss--;
+		}
+	}
+
+	// Rozwija wezel, jesli nie robi tego inny watek i w puli sa wolne wezly.
+	// Plansza watku zawiera pozycje wezla.
+	DEF bool expand(int index, MctsPlayerParams *par, MctsWorker *worker)
+	{
+		MctsNode &node = par->nodes[index];
+#ifndef NOT_TH
+		int expected = MctsNode::LEAF;
+		if (!node.state.compare_exchange_strong(expected, MctsNode::EXPANDING))
+			return false;
+#else
+		if (node.state != MctsNode::LEAF)
+			return false;
+		node.state = MctsNode::EXPANDING;
+#endif // NOT_TH
+
+		Board &board = worker->board;
+		Board::BOARD_ELEMENT_TYPE color = node.player;
+		Board::MOVES_TYPE &moves = worker->moves;
+		board.validMoves(moves, color);
+		int nMoves = moves.size();
+		bool terminal = false;
+		if (nMoves == 0)
+		{
+			board.validMoves(moves, -color);
+			terminal = moves.size() == 0;
+		}
+		int nChildren = terminal ? 0 : std::max(nMoves, 1);
+
+		int first = 0;
+		if (nChildren > 0)
+		{
+			// przekroczenie puli przez rownolegle watki jest ograniczone sprawdzeniem przed przydzialem
+			if (par->next + nChildren > par->capacity || (first = (par->next += nChildren) - nChildren) + nChildren > par->capacity)
+			{
+				node.state = MctsNode::LEAF;
+				return false;
+			}
+		}
+
+		if (nMoves == 0)
+		{
+			if (nChildren > 0)
+				initNode(par->nodes[first], -1, 0, board.getHash(-color), -color, 1.0f);
+		}
+		else
+		{
+			setPriors(board, moves, color, par, worker);
+			for (int i = 0; i < nMoves; i++)
+			{
+				board.makeMove(moves[i], moves.getFlips(i), color);
+				initNode(par->nodes[first + i], moves[i], moves.getFlips(i), board.getHash(-color), -color, worker->values[i]);
+				board.undoMove(moves[i], moves.getFlips(i), color);
+			}
+		}
+
+		node.firstChild = first;
+		node.nChildren = nChildren;
+		node.terminal = terminal;
+		node.state = MctsNode::EXPANDED;
+		return true;
+	}
+
+	// Wypelnia worker->values prawdopodobienstwami ruchow z listy (PUCT) lub rownymi wartosciami.
+	DEF void setPriors(Board &board, Board::MOVES_TYPE &moves, Board::BOARD_ELEMENT_TYPE color, MctsPlayerParams *par, MctsWorker *worker)
+	{
+		int nMoves = moves.size();
+		PlayerParams *evalParams = nullptr;
+		CpuPlayer *evaluator = puct ? player->getEvaluator(&board, worker->params, &evalParams) : nullptr;
+		if (evaluator == nullptr)
+		{
+			for (int i = 0; i < nMoves; i++)
+				worker->values[i] = 1.0f / nMoves;
+			return;
+		}
+
+		// jak w Othello::play - negowany gracz bialych ocenia plansze z perspektywy czarnych
+		bool negated = color == Board::WHITE && player->isNegated(&board);
+		Board::BOARD_ELEMENT_TYPE perspective = negated ? Board::BLACK : color;
+		Board::EVALUATION_TYPE max = -std::numeric_limits<Board::EVALUATION_TYPE>::max();
+		for (int i = 0; i < nMoves; i++)
+		{
+			Board::EVALUATION_TYPE value = evaluator->evaluateMove(&board, moves[i], moves.getFlips(i), color, perspective, evalParams, &worker->data);
+			worker->values[i] = negated ? -value : value;
+			max = std::max(max, worker->values[i]);
+		}
+		float sum = 0;
+		for (int i = 0; i < nMoves; i++)
+		{
+			worker->values[i] = std::exp((worker->values[i] - max) / temperature);
+			sum += worker->values[i];
+		}
+		for (int i = 0; i < nMoves; i++)
+			worker->values[i] /= sum;
+	}
+
+	// Dziecko rozwinietego wezla wybrane wedlug UCT lub PUCT. Nieukonczone symulacje
+	// (virtualLoss) licza sie jako porazki gracza wykonujacego ruch.
+	DEF int select(MctsNode &node, MctsPlayerParams *par)
+	{
+		int parentVisits = node.visits + node.virtualLoss;
+		float exploration = puct ? c * std::sqrt((float)parentVisits + 1) : 0;
+		float logVisits = puct ? 0 : std::log((float)parentVisits + 1);
+		int best = node.firstChild;
+		float bestScore = -std::numeric_limits<float>::max();
+		for (int i = 0; i < node.nChildren; i++)
+		{
+			MctsNode &child = par->nodes[node.firstChild + i];
+			int visits = child.visits + child.virtualLoss;
+			float score;
+			if (puct)
+			{
+				float value = visits > 0 ? child.wins / (2.0f * visits) : FIRST_PLAY_VALUE;
+				score = value + exploration * child.prior / (1 + visits);
+			}
+			else
+			{
+				if (visits == 0)
+					return node.firstChild + i;
+				score = child.wins / (2.0f * visits) + c * std::sqrt(logVisits / visits);
+			}
+			if (score > bestScore)
+			{
+				bestScore = score;
+				best = node.firstChild + i;
+			}
+		}
+		return best;
+	}
+
+	// Rozgrywa gre od pozycji na planszy watku i zwraca kolor zwyciezcy (EMPTY - remis).
+	DEF Board::BOARD_ELEMENT_TYPE rollout(MctsWorker *worker, Board::BOARD_ELEMENT_TYPE color)
+	{
+		Board &board = worker->board;
+		Board::MOVES_TYPE &moves = worker->moves;
+		int passes = 0;
+		while (passes < 2)
+		{
+			board.validMoves(moves, color);
+			int nMoves = moves.size();
+			if (nMoves == 0)
+			{
+				passes++;
+			}
+			else
+			{
+				passes = 0;
+				int i = 0;
+				if (nMoves == 1)
+					i = 0;
+				else if (randomFreq >= 1 || (randomFreq > 0 && worker->randFloat.getValue() < randomFreq))
+					i = worker->rand.getValue(nMoves);
+				else
+					i = moves.find(player->getMove(&board, &moves, color, color == Board::WHITE && player->isNegated(&board), worker->params, &worker->data));
+				board.makeMove(moves[i], moves.getFlips(i), color);
+			}
+			color = -color;
+		}
+
+		Tuple<int, int> counts = board.counts();
+		if (counts.item1 > counts.item2)
+			return Board::BLACK;
+		if (counts.item1 < counts.item2)
+			return Board::WHITE;
+		return Board::EMPTY;
+	}
+};
+
+#endif //MCTS_PLAYER_H
@@ -0,0 +1,80 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include "Header.h"
+
+// Lista poprawnych ruchow wraz z maskami pionow przejmowanych przez kazdy z nich.
+// Maski wyznaczane sa raz, podczas generowania ruchow, i wykorzystywane
+// zarowno przy ocenie ruchu, jak i przy jego wykonaniu.
+template <typename INDEX_TYPE, typename MASK_TYPE, int SIZE> class MoveList
+{
+protected:
+	// Indeksy pol, na ktorych mozna postawic pion.
+	INDEX_TYPE moves[SIZE];
+	// Maski pionow przejmowanych przez odpowiadajacy ruch.
+	MASK_TYPE flips[SIZE];
+	// Aktualna liczba przechowywanych ruchow.
+	int n;
+public:
+	DEF MoveList()
+	{
+		n = 0;
+	}
+
+	// Ilosc ruchow na liscie.
+	DEF int size() const
+	{
+		return n;
+	}
+
+	DEF static int maxSize()
+	{
+		return SIZE;
+	}
+
+	// Zwraca indeks pola ruchu pod wskazana pozycja listy.
+	DEF INDEX_TYPE operator[](int index) const
+	{
+		return moves[index];
+	}
+
+	// Zwraca maske pionow przejmowanych przez ruch pod wskazana pozycja listy.
+	DEF MASK_TYPE getFlips(int index) const
+	{
+		return flips[index];
+	}
+
+	// Dodaje ruch na koncu listy.
+	DEF void add(INDEX_TYPE move, MASK_TYPE moveFlips)
+	{
+		moves[n] = move;
+		flips[n] = moveFlips;
+		n++;
+	}
+
+	// Usuwa wszystkie ruchy z listy.
+	DEF void clear()
+	{
+		n = 0;
+	}
+
+	// Zwraca pozycje ruchu na liscie lub -1, jesli go nie ma.
+	DEF int find(INDEX_TYPE move) const
+	{
+		for(int i = 0; i < n; i++)
+		{
+			if (moves[i] == move)
+				return i;
+		}
+
+		return -1;
+	}
+
+	// Sprawdza istnienie ruchu, przeszukujac liste od poczatku.
+	DEF bool containsBegin(INDEX_TYPE move) const
+	{
+		return find(move) >= 0;
+	}
+};
+
+#endif //MOVE_LIST_H
@@ -2,6 +2,7 @@
 #define N_TUPLE_H
 
 #include "Board.h"
+#include "SparseSet.h"
 
 class NTuple
 {
@@ -9,6 +10,7 @@ public:
 	DEF NTuple()
 	{
 		n = 0;
+		maxIndex = 0;
 		fields = nullptr;
 		weights = nullptr;
 	}
@@ -18,19 +20,56 @@ public:
 		this->n = n;
 		this->fields = fields;
 		this->weights = weights;
+		maxIndex = 1;
+		for (unsigned char i = 0; i < n; i++)
+			maxIndex *= 3;
+		maxIndex--;
 	}
 
-	DEF Board::EVALUATION_TYPE getValue(Board *board)
+	// perspective - kolor pionow traktowanych jako wlasne (czarne)
+	DEF Board::EVALUATION_TYPE getValue(Board *board, Board::BOARD_ELEMENT_TYPE perspective)
 	{
 		int index = 0;
 		for (unsigned char i = 0; i < n; i++)
 		{
 			index *= 3;
-			index += getWeightIndex(board, fields[i]);
+			index += getWeightIndex(board, fields[i], perspective);
 		}
 		return weights[index];
 	}
 
+	// Zwraca wage dla indeksu wyznaczonego z perspektywy czarnych.
+	// Zamiana perspektywy odwraca cyfry (0 <-> 2), czyli indeks na maxIndex - index.
+	DEF Board::EVALUATION_TYPE getWeight(int index, Board::BOARD_ELEMENT_TYPE perspective)
+	{
+		return weights[perspective == Board::BLACK ? index : maxIndex - index];
+	}
+
+	DEF unsigned char getN() const
+	{
+		return n;
+	}
+
+	DEF Board::INDEX_TYPE getField(int i) const
+	{
+		return fields[i];
+	}
+
+	// Waga i-tego pola w indeksie krotki (3^(n-1-i)).
+	DEF int getPower(int i) const
+	{
+		int power = 1;
+		for (int j = i + 1; j < n; j++)
+			power *= 3;
+		return power;
+	}
+
+	// Najwiekszy indeks krotki (3^n - 1).
+	DEF int getMaxIndex() const
+	{
+		return maxIndex;
+	}
+
 	DEF bool isIn(const SparseSet<Board::BOARD_ELEMENT_TYPE, Board::SIZE, Board::MAX_CH_POS> &set)
 	{
 		for (int i = 0; i < n; i++)
@@ -50,13 +89,14 @@ public:
 	}
 private:
 	unsigned char n;
+	int maxIndex;
 	Board::INDEX_TYPE *fields;
 	Board::EVALUATION_TYPE *weights;
 
-	DEF unsigned char getWeightIndex(Board *board, Board::INDEX_TYPE field)
+	DEF unsigned char getWeightIndex(Board *board, Board::INDEX_TYPE field, Board::BOARD_ELEMENT_TYPE perspective)
 	{
 		Board::BOARD_ELEMENT_TYPE value = board->getValue(field);
-		return 2 - (value + 1);
+		return 1 + perspective * value;
 	}
 };
 
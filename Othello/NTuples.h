@@ -40,64 +40,121 @@ public:
 		printf("NTuples(const NTuples &nTuples)\n");
 	}
 
-	DEF Board::EVALUATION_TYPE getValue(Board *board, Board::INDEX_TYPE move, Board::BOARD_ELEMENT_TYPE player, NTuplePlayerParams<N_TUPLES> *p, GameData *data)
+	// Ocenia ruch na podstawie indeksow krotek utrzymywanych w parametrach gracza.
+	// Plansza nie jest modyfikowana - zmiana indeksu kazdej dotknietej krotki
+	// wyznaczana jest z tablicy poteg 3 dla przejmowanych pol.
+	DEF Board::EVALUATION_TYPE getValue(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, NTuplePlayerParams<N_TUPLES> *p, GameData *data)
 	{
-	    p->indexes.clear();
-		data->tmpBoard.copy(board);
-		data->tmpBoard.simulateMove(&(data->positions), move, player);
-		for (int i = 0; i < data->positions.size(); i++)
+		synchronize(board, p);
+
+		// Cyfra pola z perspektywy czarnych to 1 - wartosc pola.
+		p->indexes.clear();
+		Board::BITBOARD_TYPE mask = flips;
+		while (mask)
 		{
-			for (int j = 0; j < tuplesInPos[data->positions[i] - (Board::WIDTH + 1)].size(); j++)
-				p->indexes.add(tuplesInPos[data->positions[i] - (Board::WIDTH + 1)][j]);
+			addDeltas(p, Board::bitScanForward(mask), -2 * player);
+			mask &= mask - 1;
 		}
+		addDeltas(p, Board::getBitIndex(move), -player);
 
 		Board::EVALUATION_TYPE result = 0;
 
 		for (int i = 0; i < p->indexes.size(); i++)
-			result -= tuples[p->indexes[i]].getValue(&(data->tmpBoard));
-
-		data->tmpBoard.performMove(&(data->positions), player);
+		{
+			int t = p->indexes[i];
+			result -= tuples[t].getWeight(p->tupleIndexes[t], perspective);
+		}
 
 		for (int i = 0; i < p->indexes.size(); i++)
-			result += tuples[p->indexes[i]].getValue(&(data->tmpBoard));
+		{
+			int t = p->indexes[i];
+			result += tuples[t].getWeight(p->tupleIndexes[t] + p->deltas[t], perspective);
+		}
 
 		return result;
 	}
 
+	// Ustawia indeksy krotek odpowiadajace pustej planszy.
+	DEF void initParams(NTuplePlayerParams<N_TUPLES> *p)
+	{
+		p->pawns[0] = 0;
+		p->pawns[1] = 0;
+		for (int i = 0; i < tuples.size(); i++)
+			p->tupleIndexes[i] = tuples[i].getMaxIndex() / 2;
+	}
+
+	// Uaktualnia indeksy krotek o pola, ktore zmienily sie od ostatniego wywolania.
+	// Zazwyczaj sa to jedynie pola zmienione przez dwa ostatnie ruchy.
+	DEF void synchronize(Board *board, NTuplePlayerParams<N_TUPLES> *p)
+	{
+		Board::BITBOARD_TYPE black = board->getPawns(Board::BLACK);
+		Board::BITBOARD_TYPE white = board->getPawns(Board::WHITE);
+		Board::BITBOARD_TYPE changed = (black ^ p->pawns[0]) | (white ^ p->pawns[1]);
+		while (changed)
+		{
+			int bit = Board::bitScanForward(changed);
+			int oldValue = (int)((p->pawns[1] >> bit) & 1) - (int)((p->pawns[0] >> bit) & 1);
+			int newValue = (int)((white >> bit) & 1) - (int)((black >> bit) & 1);
+			const Vector<TuplePower, TUPLES_PER_FIELD> &inPos = tuplesInPos[bit];
+			for (int j = 0; j < inPos.size(); j++)
+				p->tupleIndexes[inPos[j].tuple] += (oldValue - newValue) * inPos[j].power;
+			changed &= changed - 1;
+		}
+		p->pawns[0] = black;
+		p->pawns[1] = white;
+	}
+
 	DEF Board::EVALUATION_TYPE *getWeights()
 	{
 		return weights;
 	}
 private:
+	// Krotka zawierajaca pole wraz z waga (potega 3) pola w indeksie krotki.
+	struct TuplePower
+	{
+		short tuple;
+		int power;
+	};
+
 	Board::INDEX_TYPE fields[N_FIELDS];
 	Board::EVALUATION_TYPE weights[N_WEIGHTS];
 	Vector<NTuple, N_TUPLES> tuples;
-	Vector<Vector<short, TUPLES_PER_FIELD>, Board::SIZE - 2 * (Board::WIDTH + 1)> tuplesInPos;
+	// Krotki zawierajace pole o wskazanym numerze bitu.
+	Vector<Vector<TuplePower, TUPLES_PER_FIELD>, 64> tuplesInPos;
 
 	DEF void calculatePos()
 	{
 		tuplesInPos.clear();
 		for (int i = 0; i < tuplesInPos.maxSize(); i++)
 		{
-			tuplesInPos.add(Vector<short, TUPLES_PER_FIELD>());
+			tuplesInPos.add(Vector<TuplePower, TUPLES_PER_FIELD>());
 			for (int j = 0; j < tuples.size(); j++)
 			{
-				if (tuples[j].contains(getGlobalIndex(i)))
+				for (int k = 0; k < tuples[j].getN(); k++)
 				{
-					tuplesInPos.ref(i).add(j);
+					if (tuples[j].getField(k) == Board::getFieldIndex(i))
+					{
+						TuplePower tp;
+						tp.tuple = j;
+						tp.power = tuples[j].getPower(k);
+						tuplesInPos.ref(i).add(tp);
+					}
 				}
 			}
 		}
 	}
 
-	DEF Board::INDEX_TYPE getLocalIndex(Board::INDEX_TYPE globalIndex)
+	// Dodaje zmiane cyfry pola do zmian indeksow zawierajacych je krotek.
+	DEF void addDeltas(NTuplePlayerParams<N_TUPLES> *p, int bit, int digitDelta)
 	{
-		return globalIndex - (Board::WIDTH + 1);
-	}
-
-	DEF Board::INDEX_TYPE getGlobalIndex(Board::INDEX_TYPE localIndex)
-	{
-		return localIndex + (Board::WIDTH + 1);
+		const Vector<TuplePower, TUPLES_PER_FIELD> &inPos = tuplesInPos[bit];
+		for (int j = 0; j < inPos.size(); j++)
+		{
+			int t = inPos[j].tuple;
+			if (p->indexes.add(t))
+				p->deltas[t] = 0;
+			p->deltas[t] += digitDelta * inPos[j].power;
+		}
 	}
 };
 
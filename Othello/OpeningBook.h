@@ -0,0 +1,181 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include "Header.h"
+#include "Board.h"
+#include "Vector.h"
+
+// Ksiazka otwarc: statystyki ruchow (liczba gier i zdobyte punkty gracza wykonujacego
+// ruch) w pozycjach z poczatku gier, wyznaczone przez OpeningBookBuilder.
+// Pozycje wyszukiwane sa po skrocie Zobrista z graczem wykonujacym ruch w tablicy
+// z adresowaniem otwartym, wiec zapytanie kosztuje jedno siegniecie do tablicy
+// i przejrzenie ruchow pozycji. Ksiazka nie zmienia sie po wczytaniu, wiec moze byc
+// uzywana jednoczesnie przez wiele watkow.
+// Plik: BOOK_FORMAT, liczba wpisow i wpisy (skrot, ruch, gry, punkty) posortowane wedlug skrotu.
+class OpeningBook
+{
+public:
+	static const int BOOK_FORMAT = 0x4B4F4F42;
+
+	// Statystyki ruchu move w pozycji o skrocie key.
+	struct Entry
+	{
+		Board::HASH_TYPE key;
+		Board::INDEX_TYPE move;
+		unsigned games;
+		// Punkty gracza wykonujacego ruch w polowkach (wygrana 2, remis 1).
+		unsigned points;
+	};
+
+	// entries - wpisy posortowane wedlug skrotu.
+	OpeningBook(const std::vector<Entry> &entries) : entries(entries)
+	{
+		int nPositions = 0;
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			if (i == 0 || entries[i].key != entries[i - 1].key)
+				nPositions++;
+		}
+		size = 1;
+		while (size < 2 * nPositions)
+			size <<= 1;
+		slots.resize(size);
+		for (int i = 0; i < size; i++)
+			slots[i].count = 0;
+
+		for (size_t i = 0; i < entries.size(); )
+		{
+			size_t j = i;
+			while (j < entries.size() && entries[j].key == entries[i].key)
+				j++;
+			int index = (int)(entries[i].key & (size - 1));
+			while (slots[index].count > 0)
+				index = (index + 1) & (size - 1);
+			slots[index].key = entries[i].key;
+			slots[index].first = (int)i;
+			slots[index].count = (int)(j - i);
+			i = j;
+		}
+		this->nPositions = nPositions;
+	}
+
+	static OpeningBook *load(const std::string &filename)
+	{
+		std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+		int format = 0;
+		int nEntries = 0;
+		if (!file.read(reinterpret_cast<char *>(&format), sizeof(format)) || format != BOOK_FORMAT
+			|| !file.read(reinterpret_cast<char *>(&nEntries), sizeof(nEntries)) || nEntries < 0)
+		{
+			printf("Nie moge odczytac ksiazki otwarc: %s\n", filename.c_str());
+			return nullptr;
+		}
+
+		std::vector<Entry> entries(nEntries);
+		for (int i = 0; i < nEntries; i++)
+		{
+			int move;
+			if (!file.read(reinterpret_cast<char *>(&entries[i].key), sizeof(entries[i].key))
+				|| !file.read(reinterpret_cast<char *>(&move), sizeof(move))
+				|| !file.read(reinterpret_cast<char *>(&entries[i].games), sizeof(entries[i].games))
+				|| !file.read(reinterpret_cast<char *>(&entries[i].points), sizeof(entries[i].points)))
+			{
+				printf("Nie moge odczytac ksiazki otwarc: %s\n", filename.c_str());
+				return nullptr;
+			}
+			entries[i].move = (Board::INDEX_TYPE)move;
+		}
+		return new OpeningBook(entries);
+	}
+
+	bool save(const std::string &filename)
+	{
+		std::ofstream file(filename.c_str(), std::ofstream::binary | std::ofstream::trunc | std::ofstream::out);
+		int format = BOOK_FORMAT;
+		int nEntries = (int)entries.size();
+		file.write(reinterpret_cast<char *>(&format), sizeof(format));
+		file.write(reinterpret_cast<char *>(&nEntries), sizeof(nEntries));
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			int move = entries[i].move;
+			file.write(reinterpret_cast<char *>(&entries[i].key), sizeof(entries[i].key));
+			file.write(reinterpret_cast<char *>(&move), sizeof(move));
+			file.write(reinterpret_cast<char *>(&entries[i].games), sizeof(entries[i].games));
+			file.write(reinterpret_cast<char *>(&entries[i].points), sizeof(entries[i].points));
+		}
+		if (!file)
+		{
+			printf("Nie moge zapisac ksiazki otwarc: %s\n", filename.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	// Wypelnia bestMoves ruchami o najwiekszej sredniej liczbie punktow sposrod ruchow
+	// rozegranych w co najmniej minGames grach. Zwraca false, jesli pozycji nie ma
+	// w ksiazce, zaden ruch nie ma dosc gier lub ruchy nie zgadzaja sie z lista poprawnych.
+	DEF bool getMoves(Board::HASH_TYPE key, const Board::MOVES_TYPE *validMoves, int minGames, Vector<Board::INDEX_TYPE, Board::SIZE> &bestMoves) const
+	{
+		int index = (int)(key & (size - 1));
+		while (slots[index].count > 0 && slots[index].key != key)
+			index = (index + 1) & (size - 1);
+		const Slot &slot = slots[index];
+		if (slot.count == 0)
+			return false;
+
+		const Entry *best = nullptr;
+		for (int i = slot.first; i < slot.first + slot.count; i++)
+		{
+			const Entry &entry = entries[i];
+			if (validMoves->find(entry.move) < 0)
+				return false;
+			if ((int)entry.games < minGames)
+				continue;
+			// porownanie srednich bez dzielenia
+			uint64_t value = (uint64_t)entry.points * (best != nullptr ? best->games : 1);
+			uint64_t bestValue = best != nullptr ? (uint64_t)best->points * entry.games : 0;
+			if (best == nullptr || value > bestValue)
+			{
+				best = &entry;
+				bestMoves.clear();
+				bestMoves.add(entry.move);
+			}
+			else if (value == bestValue)
+			{
+				bestMoves.add(entry.move);
+			}
+		}
+		return best != nullptr;
+	}
+
+	DEF int getNPositions() const
+	{
+		return nPositions;
+	}
+
+	DEF int getNEntries() const
+	{
+		return (int)entries.size();
+	}
+private:
+	// Ruchy pozycji key zajmuja wpisy first..first+count-1; count == 0 - wolne miejsce.
+	struct Slot
+	{
+		Board::HASH_TYPE key;
+		int first;
+		int count;
+	};
+
+	std::vector<Entry> entries;
+	std::vector<Slot> slots;
+	int size;
+	int nPositions;
+};
+
+#endif //OPENING_BOOK_H
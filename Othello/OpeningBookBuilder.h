@@ -0,0 +1,238 @@
+#ifndef OPENING_BOOK_BUILDER_H
+#define OPENING_BOOK_BUILDER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include "Header.h"
+#include "Board.h"
+#include "OthelloPlayer.h"
+#include "OptimizerConfiguration.h"
+#include "OpeningBook.h"
+#include "ThreadPool.h"
+#include "Random.h"
+
+// Buduje ksiazke otwarc z gier graczy z konfiguracji (wszystkich, takze gracza 0).
+// Gra numer g toczy sie miedzy graczami g % n (czarne) i g / n % n (biale) od planszy
+// g % liczba plansz (lub od planszy poczatkowej, jesli konfiguracja nie podaje plansz);
+// z prawdopodobienstwem randomFreq ruch jest losowy, co roznicuje otwarcia.
+// Zapamietywane sa ruchy z pierwszych maxPlies polruchow i wynik gry, a pozycje po
+// maxPlies polruchach moga posluzyc jako zroznicowane plansze startowe.
+// Gra zalezy tylko od swojego numeru, wiec ksiazka nie zalezy od liczby watkow.
+class OpeningBookBuilder
+{
+public:
+	// Liczba gier w jednym zadaniu puli watkow.
+	static const int GAMES_PER_TASK = 256;
+
+	OpeningBookBuilder(Configuration *conf, int maxPlies, float randomFreq, int seed)
+	{
+		this->conf = conf;
+		this->maxPlies = maxPlies;
+		this->randomFreq = randomFreq;
+		this->seed = seed;
+		nGames = 0;
+		for (int i = 0; i < conf->getNPlayers(); i++)
+			players.push_back(conf->getPlayerLoader(i)->getPlayer(seed + i, conf->getPlayerNeg(i)));
+	}
+
+	~OpeningBookBuilder()
+	{
+		for (size_t i = 0; i < players.size(); i++)
+			delete players[i];
+	}
+
+	// Rozgrywa kolejne nGames gier na nThreads watkach i dodaje je do statystyk.
+	void play(int nGames, int nThreads)
+	{
+		int nTasks = (nGames + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+		int batch = std::max(nThreads, 1) * 4;
+		for (int begin = 0; begin < nTasks; begin += batch)
+		{
+			int count = std::min(batch, nTasks - begin);
+			std::vector<Result> results(count);
+			ThreadPool::getPool(nThreads).run(count, [&](int task)
+			{
+				int first = this->nGames + (begin + task) * GAMES_PER_TASK;
+				int last = std::min(first + GAMES_PER_TASK, this->nGames + nGames);
+				playGames(first, last, results[task]);
+			});
+
+			// kolejnosc laczenia nie zalezy od przydzialu zadan do watkow
+			for (int t = 0; t < count; t++)
+			{
+				for (auto it = results[t].stats.begin(); it != results[t].stats.end(); ++it)
+				{
+					Stats &stats = this->stats[it->first];
+					stats.games += it->second.games;
+					stats.points += it->second.points;
+				}
+				for (auto it = results[t].positions.begin(); it != results[t].positions.end(); ++it)
+					positions.insert(*it);
+			}
+		}
+		this->nGames += nGames;
+	}
+
+	// Ksiazka z ruchow rozegranych w co najmniej minGames grach.
+	OpeningBook *getBook(int minGames)
+	{
+		std::vector<OpeningBook::Entry> entries;
+		for (auto it = stats.begin(); it != stats.end(); ++it)
+		{
+			if ((int)it->second.games < minGames)
+				continue;
+			OpeningBook::Entry entry;
+			entry.key = it->first.first;
+			entry.move = (Board::INDEX_TYPE)it->first.second;
+			entry.games = it->second.games;
+			entry.points = it->second.points;
+			entries.push_back(entry);
+		}
+		return new OpeningBook(entries);
+	}
+
+	// Zapisuje rozne pozycje po maxPlies polruchach w formacie plansz (BoardLoader).
+	bool savePositions(const std::string &filename)
+	{
+		std::ofstream file(filename.c_str(), std::ofstream::binary | std::ofstream::trunc | std::ofstream::out);
+		int format = BOARD_FORMAT;
+		int nBoards = (int)positions.size();
+		file.write(reinterpret_cast<char *>(&format), sizeof(format));
+		file.write(reinterpret_cast<char *>(&nBoards), sizeof(nBoards));
+		for (auto it = positions.begin(); it != positions.end(); ++it)
+		{
+			Board board(it->second);
+			for (int bit = 0; bit < 64; bit++)
+			{
+				int value = board.getValue(Board::getFieldIndex(bit));
+				file.write(reinterpret_cast<char *>(&value), sizeof(value));
+			}
+		}
+		if (!file)
+		{
+			printf("Nie moge zapisac plansz: %s\n", filename.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	int getNGames()
+	{
+		return nGames;
+	}
+
+	int getNPositions()
+	{
+		return (int)positions.size();
+	}
+private:
+	// Format pliku plansz (jak AnyLoader::BOARD_FORMAT).
+	static const int BOARD_FORMAT = 2;
+
+	struct Stats
+	{
+		Stats() : games(0), points(0) { }
+
+		unsigned games;
+		unsigned points;
+	};
+
+	// Statystyki ruchow (skrot pozycji, ruch) i pozycje po maxPlies polruchach.
+	typedef std::map<std::pair<Board::HASH_TYPE, int>, Stats> STATS_MAP;
+	typedef std::map<Board::HASH_TYPE, Board> POSITIONS_MAP;
+
+	struct Result
+	{
+		STATS_MAP stats;
+		POSITIONS_MAP positions;
+	};
+
+	Configuration *conf;
+	std::vector<OthelloPlayer *> players;
+	int maxPlies;
+	float randomFreq;
+	int seed;
+	int nGames;
+	STATS_MAP stats;
+	POSITIONS_MAP positions;
+
+	void playGames(int first, int last, Result &result)
+	{
+		int n = (int)players.size();
+		// osobne parametry dla kazdego koloru, bo gracz moze grac sam ze soba
+		std::vector<PlayerParams *> params(2 * n);
+		for (int i = 0; i < 2 * n; i++)
+			params[i] = players[i % n]->getPlayerParams(seed + first + i);
+		GameData data;
+		Board::MOVES_TYPE moves;
+		std::vector<Board::HASH_TYPE> keys(maxPlies);
+		std::vector<int> played(maxPlies);
+		std::vector<Board::BOARD_ELEMENT_TYPE> movers(maxPlies);
+
+		for (int g = first; g < last; g++)
+		{
+			Random<int> random(seed + g);
+			Random<float> randomFloat(random.rand());
+			OthelloPlayer *gamePlayers[] = { players[g % n], players[g / n % n] };
+			PlayerParams *gameParams[] = { params[g % n], params[n + g / n % n] };
+			gameParams[0]->setSeed(random.rand());
+			gameParams[1]->setSeed(random.rand());
+
+			Board board;
+			BoardLoader *boards = conf->getBoards();
+			if (boards != nullptr && boards->getNBoards() > 0)
+				board.setValues(boards->getBoardValues(g % boards->getNBoards()));
+
+			int ply = 0;
+			int passes = 0;
+			Board::BOARD_ELEMENT_TYPE color = Board::BLACK;
+			while (passes < 2)
+			{
+				board.validMoves(moves, color);
+				if (moves.size() == 0)
+				{
+					passes++;
+					color = -color;
+					continue;
+				}
+				passes = 0;
+
+				int p = color == Board::BLACK ? 0 : 1;
+				int i;
+				if (randomFloat.getValue() < randomFreq)
+					i = random.getValue(moves.size());
+				else
+					i = moves.find(gamePlayers[p]->getMove(&board, &moves, color, p == 1 && gamePlayers[p]->isNegated(&board), gameParams[p], &data));
+				if (ply < maxPlies)
+				{
+					keys[ply] = board.getHash(color);
+					played[ply] = moves[i];
+					movers[ply] = color;
+				}
+				board.makeMove(moves[i], moves.getFlips(i), color);
+				ply++;
+				// gry zaczynaja czarne, wiec planszami startowymi sa pozycje z ruchem czarnych
+				if (ply == maxPlies && color == Board::WHITE)
+					result.positions[board.getHash(Board::BLACK)] = board;
+				color = -color;
+			}
+
+			Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> score = board.result();
+			for (int k = 0; k < std::min(ply, maxPlies); k++)
+			{
+				Stats &stats = result.stats[std::make_pair(keys[k], played[k])];
+				stats.games++;
+				stats.points += (unsigned)(2 * (movers[k] == Board::BLACK ? score.item1 : score.item2) + 0.5f);
+			}
+		}
+
+		for (int i = 0; i < 2 * n; i++)
+			delete params[i];
+	}
+};
+
+#endif //OPENING_BOOK_BUILDER_H
@@ -3,8 +3,10 @@
 
 #include <fstream>
 #include <vector>
+#include <map>
 #include "AnyLoader.h"
 #include "TupleLoader.h"
+#include "Watch.h"
 
 class AbsConfiguration
 {
@@ -113,6 +115,22 @@ protected:
         return true;
     }
 
+    // Wczytuje opcjonalne ustawienia w postaci "nazwa: wartosc" az do konca pliku.
+    static void loadOptions(std::ifstream &file, std::map<std::string, std::string> &options)
+    {
+        while (file.good())
+        {
+            std::string str;
+            getLine(file, str);
+            size_t separator = str.find(':');
+            if (str.length() == 0 || separator == std::string::npos)
+                continue;
+
+            size_t valueBegin = str.find_first_not_of(" \t", separator + 1);
+            options[str.substr(0, separator)] = valueBegin == std::string::npos ? "" : str.substr(valueBegin);
+        }
+    }
+
     static bool loadFloatValues(std::ifstream &file, int *nValues, float **values)
     {
         *nValues = 0;
@@ -153,6 +171,8 @@ class Configuration : AbsConfiguration
 	std::string *playersNames;
 
 	BoardLoader *boards;
+	// Ustawienia podane po opisie plansz, np. "expert_move_cache: 1048576".
+	std::map<std::string, std::string> options;
 
 	Configuration(const char** players, bool *playersNegation, float *playersFreq, int nPlayers, const char *board, int nBoards, int boardSeed, int seed) :
 		rand(seed)
@@ -213,6 +233,7 @@ class Configuration : AbsConfiguration
 
 	static Configuration *loadConf(const std::string &filename, int seed)
 	{
+		PHASE_TIMER(IO);
         std::ifstream file(filename.c_str(), std::ios::in);
         if (!file.is_open())
         {
@@ -244,10 +265,14 @@ class Configuration : AbsConfiguration
             return nullptr;
         }
 
+        std::map<std::string, std::string> options;
+        loadOptions(file, options);
+
         file.close();
 
         Configuration *conf;
 		conf = new Configuration(players, playersN, playersF, nPlayers, boardFilename.length() > 0 ? boardFilename.c_str() : nullptr, boardSize, boardSeed, seed);
+		conf->options = options;
 
         delete[] players;
         delete[] playersNames;
@@ -296,6 +321,24 @@ public:
 	{
 		return boards;
 	}
+
+	// Zwraca wartosc liczbowa ustawienia lub defaultValue, jesli go nie podano.
+	float getOption(const std::string &name, float defaultValue)
+	{
+		auto it = options.find(name);
+		if (it == options.end())
+			return defaultValue;
+		return ::atof(it->second.c_str());
+	}
+
+	// Zwraca wartosc tekstowa ustawienia lub defaultValue, jesli go nie podano.
+	std::string getOptionString(const std::string &name, const std::string &defaultValue)
+	{
+		auto it = options.find(name);
+		if (it == options.end())
+			return defaultValue;
+		return it->second;
+	}
 };
 
 class MultiConfiguration : AbsConfiguration
@@ -5,10 +5,14 @@
 #include "OthelloPlayer.h"
 #include "Board.h"
 #include "Vector.h"
+#include "Watch.h"
 
 // Przeprowadza rozgrywk.
 class Othello
 {
+	// Petla gry wybrana dla pary typow graczy.
+	typedef Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> (*PLAY_FUNCTION)(Board *, OthelloPlayer *, OthelloPlayer *, PlayerParams **,
+		Board::MOVES_TYPE *, GameData *, Rand *);
 public:
 	DEF Othello(OthelloPlayer *player, OthelloPlayer **experts, int nExperts, int seed) :
 		random(seed)
@@ -36,6 +40,7 @@ public:
 			delete params[i];
 		delete[] params;
 		delete[] players;
+		delete[] playFunctions;
 	}
 
 	// Rozgrywa par gier.
@@ -68,7 +73,7 @@ public:
 		OthelloPlayer *player1 = players[p1];
 		OthelloPlayer *player2 = players[p2];
 		PlayerParams* playersParams[] = { params[p1], params[p2] };
-		return play(board, player1, player2, playersParams, &validMoves, &possibleMoves, data, &random);
+		return playFunctions[p1 * nPlayers + p2](board, player1, player2, playersParams, &validMoves, data, &random);
 	}
 
 	DEF static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> playDouble(Board &board, OthelloPlayer *player1, OthelloPlayer *player2, int seed)
@@ -88,13 +93,11 @@ public:
 	DEF static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> play(Board &board, OthelloPlayer *player1, OthelloPlayer *player2, int seed)
 	{
 	    Rand random(seed);
-		Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> validMoves;
-        SparseSet<Board::BOARD_ELEMENT_TYPE, 100, Board::SIZE> possibleMoves;
+		Board::MOVES_TYPE validMoves;
         GameData data;
 		PlayerParams* playersParams[] = { player1->getPlayerParams(random.rand()), player2->getPlayerParams(random.rand()) };
 
-		auto result = play(&board, player1, player2, playersParams, &validMoves, &possibleMoves, &data, &random);
-		//play(Board *board, OthelloPlayer *player1, OthelloPlayer *player2, PlayerParams* playersParams[], Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, SparseSet<Board::BOARD_ELEMENT_TYPE, 100, Board::SIZE> *possibleMoves, GameData *data, Rand *random)
+		auto result = getPlayFunction(player1, player2)(&board, player1, player2, playersParams, &validMoves, &data, &random);
 
         for(int i = 0; i < 2; i++)
             delete playersParams[i];
@@ -112,6 +115,29 @@ public:
 	{
 		return board;
 	}
+
+	// Dodaje statystyki pamieci ocen wszystkich graczy tej rozgrywki.
+	DEF void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		for(int i = 0; i < nPlayers; i++)
+		{
+			if (params[i] != nullptr)
+				params[i]->addEvalCacheStats(hits, misses);
+		}
+	}
+
+	// Ustawia ziarna generatorow rozgrywki i graczy, tak aby wynik kolejnej gry
+	// nie zalezal od gier rozegranych wczesniej przez ten obiekt.
+	DEF void setSeed(int seed)
+	{
+		random = Rand(seed);
+		for(int i = 0; i < nPlayers; i++)
+		{
+			int playerSeed = random.rand();
+			if (params[i] != nullptr)
+				params[i]->setSeed(playerSeed);
+		}
+	}
 private:
 	DEF void init(OthelloPlayer **players, int nPlayers)
 	{
@@ -121,76 +147,131 @@ private:
 		for(int i = 0; i < nPlayers; i++)
 			params[i] = players[i]->getPlayerParams(random.rand());
         data = new GameData();
+		// typy graczy nie zmieniaja sie, wiec petle gry wybierane sa raz dla kazdej pary
+		playFunctions = new PLAY_FUNCTION[nPlayers * nPlayers];
+		for(int i = 0; i < nPlayers; i++)
+			for(int j = 0; j < nPlayers; j++)
+				playFunctions[i * nPlayers + j] = getPlayFunction(players[i], players[j]);
 	}
 
 	OthelloPlayer **players;
 	PlayerParams **params;
 	GameData *data;
 	int nPlayers;
+	// Petla gry dla pary graczy (i, j) pod indeksem i * nPlayers + j.
+	PLAY_FUNCTION *playFunctions;
 
 	Rand random;
 
 	Board board;
-	Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> validMoves;
-	SparseSet<Board::BOARD_ELEMENT_TYPE, 100, Board::SIZE> possibleMoves;
+	Board::MOVES_TYPE validMoves;
+
+	DEF static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> play(Board *board, OthelloPlayer *player1, OthelloPlayer *player2, PlayerParams* playersParams[], Board::MOVES_TYPE *validMoves, GameData *data, Rand *random)
+	{
+		return playTyped(board, player1, player2, playersParams, validMoves, data, random);
+	}
 
-	DEF static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> play(Board *board, OthelloPlayer *player1, OthelloPlayer *player2, PlayerParams* playersParams[], Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, SparseSet<Board::BOARD_ELEMENT_TYPE, 100, Board::SIZE> *possibleMoves, GameData *data, Rand *random)
+	// Petla gry graczy typow P1 (czarne) i P2 (biale). Dla typow oznaczonych final
+	// (WPCPlayer, NTuplePlayer, DynamicNTuplePlayer) getMove, isNegated i ocena ruchow
+	// wywolywane sa bezposrednio, wiec kompilator moze rozwinac ocene w petli gry.
+	// Dla OthelloPlayer wywolania sa wirtualne. Przebieg gry nie zalezy od typow.
+	template <typename P1, typename P2>
+	DEF static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> playTyped(Board *board, P1 *player1, P2 *player2, PlayerParams* playersParams[], Board::MOVES_TYPE *validMoves, GameData *data, Rand *random)
 	{
 		Random<float> r(random->rand());
 		Random<int> r2(random->rand());
 	    validMoves->clear();
-		possibleMoves->clear();
-		board->possibleMoves(*possibleMoves);
 		bool aMoveWasPossible;
-		OthelloPlayer* players[] = { player1, player2 };
 
+		// plansza nie jest odwracana - gracz otrzymuje swoj kolor,
+		// a nienegowany gracz ocenia plansze wzgledem wlasnych pionow
 		do
 		{
-			aMoveWasPossible = false;
-			for (int p = 0; p < 2; p++)
-			{
-                bool negated = false;
-                if (p == 1)
-                {
-                    negated = player2->isNegated(board);
-                }
-                bool boardInversion = !negated && p != 0;
-
-				if (boardInversion)
-                    board->invert();
-
-				OthelloPlayer *player = players[p];
-				PlayerParams *par = playersParams[p];
-				Board::BOARD_ELEMENT_TYPE playerColor = (p == 0 || boardInversion) ? Board::BLACK : Board::WHITE;
-				board->validMoves(*validMoves, *possibleMoves, playerColor);
-				if (validMoves->size() == 0)
-				{
-					if (boardInversion)
-                        board->invert();
-					continue;
-				}
-
-				int move = (*validMoves)[0];
-				if (player->getRandomMoveFreq() > r.getValue())
-				{
-					move = (*validMoves)[r2.getValue(validMoves->size())];
-				}
-				else
-				{
-					move = player->getMove(board, validMoves, playerColor, negated, par, data);
-				}
-
-				board->makeMove(move, playerColor);
-				if (boardInversion)
-                    board->invert();
-				board->updatePossibleMoves(*possibleMoves, move);
+			aMoveWasPossible = playMove(board, player1, Board::BLACK, false, playersParams[0], validMoves, data, r, r2);
+			if (playMove(board, player2, Board::WHITE, player2->isNegated(board), playersParams[1], validMoves, data, r, r2))
 				aMoveWasPossible = true;
-			}
 		}
 		while (aMoveWasPossible);
 
 		return board->result();
 	}
+
+	// Wykonuje ruch gracza; zwraca false, jesli gracz nie mial ruchu.
+	template <typename P>
+	DEF static bool playMove(Board *board, P *player, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *par, Board::MOVES_TYPE *validMoves, GameData *data,
+		Random<float> &r, Random<int> &r2)
+	{
+		{
+			PHASE_TIMER(MOVE_GENERATION);
+			board->validMoves(*validMoves, playerColor);
+		}
+		if (validMoves->size() == 0)
+			return false;
+
+		// pozycja ruchu na liscie - przejmowane piony sa juz wyznaczone
+		int moveNumber = 0;
+		if (player->getRandomMoveFreq() > r.getValue())
+		{
+			moveNumber = r2.getValue(validMoves->size());
+		}
+		else
+		{
+			moveNumber = validMoves->find(selectMove(player, board, validMoves, playerColor, negated, par, data));
+		}
+
+		board->makeMove((*validMoves)[moveNumber], validMoves->getFlips(moveNumber), playerColor);
+		return true;
+	}
+
+	DEF static Board::INDEX_TYPE selectMove(OthelloPlayer *player, Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *par, GameData *data)
+	{
+		return player->getMove(board, validMoves, playerColor, negated, par, data);
+	}
+
+	template <typename P>
+	DEF static Board::INDEX_TYPE selectMove(P *player, Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *par, GameData *data)
+	{
+		return player->template chooseMove<P>(board, validMoves, playerColor, negated, par, data);
+	}
+
+	template <typename P1, typename P2>
+	static Tuple<Board::EVALUATION_TYPE, Board::EVALUATION_TYPE> playCast(Board *board, OthelloPlayer *player1, OthelloPlayer *player2, PlayerParams* playersParams[],
+		Board::MOVES_TYPE *validMoves, GameData *data, Rand *random)
+	{
+		return playTyped(board, static_cast<P1 *>(player1), static_cast<P2 *>(player2), playersParams, validMoves, data, random);
+	}
+
+	// Wybiera petle gry dla typu bialych przy znanym typie czarnych P1.
+	template <typename P1>
+	static PLAY_FUNCTION getPlayFunction(OthelloPlayer *player2)
+	{
+		if (dynamic_cast<WPCPlayer *>(player2) != nullptr)
+			return &playCast<P1, WPCPlayer>;
+		if (dynamic_cast<DynamicNTuplePlayer *>(player2) != nullptr)
+			return &playCast<P1, DynamicNTuplePlayer>;
+#ifdef STATIC_NTUPLES
+		if (dynamic_cast<NTuplePlayer<576, 8748, 96, 22> *>(player2) != nullptr)
+			return &playCast<P1, NTuplePlayer<576, 8748, 96, 22> >;
+#endif // STATIC_NTUPLES
+		return &playCast<P1, OthelloPlayer>;
+	}
+
+	// Wybiera petle gry dla pary graczy (raz, przy tworzeniu rozgrywki). Wyspecjalizowane
+	// sa typy graczy CpuPlayer uzywane w konfiguracjach (z STATIC_NTUPLES takze najczesciej
+	// uzywany ksztalt NTuplePlayer); pozostali gracze (MultiPlayer, SearchPlayer itd.)
+	// wywolywani sa wirtualnie, a ich przeciwnik nadal bezposrednio.
+	static PLAY_FUNCTION getPlayFunction(OthelloPlayer *player1, OthelloPlayer *player2)
+	{
+		if (dynamic_cast<WPCPlayer *>(player1) != nullptr)
+			return getPlayFunction<WPCPlayer>(player2);
+		if (dynamic_cast<DynamicNTuplePlayer *>(player1) != nullptr)
+			return getPlayFunction<DynamicNTuplePlayer>(player2);
+#ifdef STATIC_NTUPLES
+		if (dynamic_cast<NTuplePlayer<576, 8748, 96, 22> *>(player1) != nullptr)
+			return getPlayFunction<NTuplePlayer<576, 8748, 96, 22> >(player2);
+#endif // STATIC_NTUPLES
+		return getPlayFunction<OthelloPlayer>(player2);
+	}
 };
 
 #endif //OTHELLO_H
@@ -8,10 +8,17 @@
 #include "Header.h"
 #include "Board.h"
 #include "Vector.h"
+#include "Watch.h"
 #include "TupleLoader.h"
 #include "NTuples.h"
+#include "DynamicNTuples.h"
+#include "ExpertMoveCache.h"
+#include "OpeningBook.h"
 
 class OthelloPlayer;
+class CpuPlayer;
+class SearchPlayer;
+class MctsPlayer;
 template <bool negated>
 class CpuPlayer1;
 template <int N_PLAYERS>
@@ -31,7 +38,7 @@ public:
 	typedef OthelloPlayer BASE_PLAYER_TYPE;
 
 	// Zwraca najlepszy swoim zdaniem ruch dla zadanego stanu.
-	DEF virtual Board::INDEX_TYPE getMove(Board *board, Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, Board::BOARD_ELEMENT_TYPE playerd, bool negated, PlayerParams *p, GameData *data) = 0;
+	DEF virtual Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerd, bool negated, PlayerParams *p, GameData *data) = 0;
 
 	DEF virtual bool isNegated(Board *board)
 	{
@@ -58,6 +65,25 @@ public:
 	}
 
 	DEF virtual PlayerParams *getPlayerParams(int seed) = 0;
+
+	// Wlacza zapamietywanie wybieranych ruchow (tylko dla graczy o stalych wagach).
+	// id - numer gracza w pamieci, cache == nullptr wylacza pamiec.
+	DEF virtual void setMoveCache(ExpertMoveCache *cache, int id) { }
+
+	// Wlacza pamiec ocen ruchow o nEntries wpisach w parametrach gracza
+	// (osobna dla kazdej gry, a wiec i watku); 0 wylacza pamiec.
+	DEF virtual void setEvalCache(int nEntries) { }
+
+	// Wlacza wybor ruchow z ksiazki otwarc (ruchy rozegrane w co najmniej minGames grach);
+	// book == nullptr wylacza ksiazke. Ksiazka nalezy do wywolujacego.
+	DEF virtual void setOpeningBook(const OpeningBook *book, int minGames) { }
+
+	// Zwraca gracza oceniajacego ruchy w pozycji board i ustawia jego parametry
+	// w evalParams (nullptr, jesli gracz nie ocenia pojedynczych ruchow).
+	DEF virtual CpuPlayer *getEvaluator(Board *board, PlayerParams *p, PlayerParams **evalParams)
+	{
+		return nullptr;
+	}
 private:
 	float randomMoveFreq;
 protected:
@@ -66,7 +92,7 @@ protected:
 
 class ConsoleOthelloPlayer : public OthelloPlayer
 {
-	DEF Board::INDEX_TYPE getMove(Board *board, Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, Board::BOARD_ELEMENT_TYPE player, bool negated, PlayerParams *p, GameData *data)
+	DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE player, bool negated, PlayerParams *p, GameData *data)
 	{
 		#if WIN32
 		system("cls");
@@ -107,46 +133,93 @@ class ConsoleOthelloPlayer : public OthelloPlayer
 class CpuPlayer : public OthelloPlayer
 {
     template <int N_PLAYERS> friend class MultiPlayer;
+    friend class SearchPlayer;
+    friend class MctsPlayer;
 #define EPS_VALUE 0.00001
 public:
 	DEF CpuPlayer(int seed, bool negated)
 	{
 	    this->negated = negated;
+	    moveCache = nullptr;
+	    moveCacheId = 0;
+	    evalCacheSize = 0;
+	    book = nullptr;
+	    bookMinGames = 1;
+	    weightsVersion = 1;
 	}
 
-	DEF Board::INDEX_TYPE getMove(Board *board, Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, Board::BOARD_ELEMENT_TYPE player, bool negated, PlayerParams *p,
+	DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE player, bool negated, PlayerParams *p,
                                #ifndef ON_STACK
                                GameData *data
                                #endif //ON_STACK
                                )
 	{
+		return chooseMove<CpuPlayer>(board, validMoves, player, negated, p, data);
+	}
+
+	// Wybor ruchu z ocena ruchow przez evaluateMove typu PLAYER (typu tego obiektu).
+	// Dla klasy oznaczonej final wywolanie nie jest wirtualne, wiec petla gry
+	// (Othello::playTyped) moze rozwinac ocene ruchow w miejscu wywolania.
+	template <typename PLAYER>
+	DEF Board::INDEX_TYPE chooseMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE player, bool negated, PlayerParams *p, GameData *data)
+	{
 #if 0
-		auto val = evaluateMove(board, validMoves[0][0], player, p, data);
+		auto val = evaluateMove(board, validMoves[0][0], validMoves->getFlips(0), player, player, p, data);
 		Board::INDEX_TYPE result = validMoves[0][0];
 		return result;
 #else
-		//bool negate = isNegated() && player == Board::WHITE;
-		p->bestMoves.clear();
-		Board::EVALUATION_TYPE bestEvaluation = Board::WORSE_EVAL;
-
-		for (int i = 0; i < validMoves->size(); i++)
+		PLAYER *self = static_cast<PLAYER *>(this);
+		// negowany gracz ocenia plansze z perspektywy czarnych i neguje wynik,
+		// pozostali oceniaja ja wzgledem wlasnego koloru
+		Board::BOARD_ELEMENT_TYPE perspective = negated ? Board::BLACK : player;
+		PHASE_TIMER(EVALUATION);
+		int cacheId = 2 * moveCacheId + (negated ? 1 : 0);
+		// pozycja z ksiazki otwarc nie jest oceniana
+		bool fromBook = book != nullptr && book->getMoves(board->getHash(player), validMoves, bookMinGames, p->bestMoves);
+		if (!fromBook && (moveCache == nullptr || !moveCache->get(cacheId, board->getHash(player), validMoves, p->bestMoves)))
 		{
-			Board::EVALUATION_TYPE value;
-			if (negated)
-				value = -evaluateMove(board, validMoves[0][i], player, p, data);
-			else
-				value = evaluateMove(board, validMoves[0][i], player, p, data);
-
-			if (value == bestEvaluation || std::abs(value - bestEvaluation) < EPS_VALUE)
+			// oceny zapamietane dla tej pozycji (nullptr - brak) i oceny do zapamietania
+			const Board::EVALUATION_TYPE *cached = nullptr;
+			Board::EVALUATION_TYPE values[EvalCache::MAX_VALUES];
+			Board::HASH_TYPE key = 0;
+			prepareEvalCache(p);
+			if (p->evalCache != nullptr)
 			{
-				p->bestMoves.add(validMoves[0][i]);
+				key = EvalCache::getKey(board->getHash(player), perspective);
+				cached = p->evalCache->get(key, weightsVersion, validMoves->size());
 			}
-			else if (bestEvaluation < value || i == 0)
+
+			p->bestMoves.clear();
+			Board::EVALUATION_TYPE bestEvaluation = Board::WORSE_EVAL;
+
+			for (int i = 0; i < validMoves->size(); i++)
 			{
-				bestEvaluation = value;
-				p->bestMoves.clear();
-				p->bestMoves.add(validMoves[0][i]);
+				Board::EVALUATION_TYPE value;
+				if (cached != nullptr && i < EvalCache::MAX_VALUES)
+					value = cached[i];
+				else
+					value = self->evaluateMove(board, validMoves[0][i], validMoves->getFlips(i), player, perspective, p, data);
+				if (i < EvalCache::MAX_VALUES)
+					values[i] = value;
+				if (negated)
+					value = -value;
+
+				if (value == bestEvaluation || std::abs(value - bestEvaluation) < EPS_VALUE)
+				{
+					p->bestMoves.add(validMoves[0][i]);
+				}
+				else if (bestEvaluation < value || i == 0)
+				{
+					bestEvaluation = value;
+					p->bestMoves.clear();
+					p->bestMoves.add(validMoves[0][i]);
+				}
 			}
+
+			if (p->evalCache != nullptr && cached == nullptr)
+				p->evalCache->put(key, weightsVersion, validMoves->size(), values);
+			if (moveCache != nullptr)
+				moveCache->put(cacheId, board->getHash(player), validMoves, p->bestMoves);
 		}
 
 		switch (p->bestMoves.size())
@@ -176,15 +249,71 @@ public:
 	{
 		return negated;
 	}
+
+	DEF void setMoveCache(ExpertMoveCache *cache, int id)
+	{
+		moveCache = cache;
+		moveCacheId = id;
+	}
+
+	DEF void setEvalCache(int nEntries)
+	{
+		evalCacheSize = nEntries;
+	}
+
+	DEF void setOpeningBook(const OpeningBook *book, int minGames)
+	{
+		this->book = book;
+		bookMinGames = minGames;
+	}
+
+	DEF CpuPlayer *getEvaluator(Board *board, PlayerParams *p, PlayerParams **evalParams)
+	{
+		*evalParams = p;
+		return this;
+	}
 protected:
+	// Uniewaznia oceny zapamietane dla poprzednich wag; wywolywane przez setWeights.
+	DEF void invalidateEvalCache()
+	{
+		weightsVersion++;
+	}
+
 	// Ocena wskazanego ruchu.
-	DEF virtual Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BOARD_ELEMENT_TYPE player, PlayerParams *p, GameData *data) = 0;
+	// perspective - kolor pionow traktowanych przez funkcje oceny jako wlasne (czarne)
+	DEF virtual Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, PlayerParams *p, GameData *data) = 0;
 private:
     bool negated;
+    // Pamiec wybieranych ruchow wspolna z innymi ekspertami (nullptr - brak).
+    ExpertMoveCache *moveCache;
+    int moveCacheId;
+    // Rozmiar pamieci ocen w parametrach gracza (0 - brak).
+    int evalCacheSize;
+    // Wersja wag, zwiekszana przy kazdej ich zmianie.
+    unsigned weightsVersion;
+    // Ksiazka otwarc (nullptr - brak) i najmniejsza liczba gier ruchu z ksiazki.
+    const OpeningBook *book;
+    int bookMinGames;
+
+	// Tworzy, zmienia rozmiar lub usuwa pamiec ocen w parametrach zgodnie z evalCacheSize.
+	DEF void prepareEvalCache(PlayerParams *p)
+	{
+		if (evalCacheSize <= 0)
+		{
+			delete p->evalCache;
+			p->evalCache = nullptr;
+		}
+		else if (p->evalCache == nullptr || p->evalCache->getSize() < evalCacheSize)
+		{
+			delete p->evalCache;
+			p->evalCache = new EvalCache(evalCacheSize);
+		}
+	}
 };
 
-class WPCPlayer : public CpuPlayer
+class WPCPlayer final : public CpuPlayer
 {
+	friend class CpuPlayer;
 public:
 	DEF WPCPlayer(Board::EVALUATION_TYPE *weights, bool negated, int seed)
 		: CpuPlayer(seed, negated)
@@ -195,29 +324,29 @@ private:
 	Board::EVALUATION_TYPE weights[64];
 
 protected:
-	DEF Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BOARD_ELEMENT_TYPE player, PlayerParams *p, GameData *data)
+	DEF Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, PlayerParams *p, GameData *data)
 	{
-		data->tmpBoard.copy(board);
-		data->tmpBoard.simulateMove(&(data->positions), move, player);
+		Board::getPositions(&(data->positions), move, flips);
 
 		Board::EVALUATION_TYPE result = 0;
 		for (int i = 0; i < data->positions.size(); i++)
 		{
-			result -= getValue(data->positions[i], data->tmpBoard);
+			result -= getValue(data->positions[i], *board, perspective);
 		}
-		data->tmpBoard.performMove(&(data->positions), player);
+		board->makeMove(move, flips, player);
 		for (int i = 0; i < data->positions.size(); i++)
 		{
-			result += getValue(data->positions[i], data->tmpBoard);
+			result += getValue(data->positions[i], *board, perspective);
 		}
+		board->undoMove(move, flips, player);
 
 		return result;
 	}
 
 private:
-	DEF Board::EVALUATION_TYPE getValue(Board::INDEX_TYPE index, Board &board)
+	DEF Board::EVALUATION_TYPE getValue(Board::INDEX_TYPE index, Board &board, Board::BOARD_ELEMENT_TYPE perspective)
 	{
-		return weights[getWeightIndex(index)] * board.getValue(index);
+		return weights[getWeightIndex(index)] * (Board::BOARD_ELEMENT_TYPE)(-perspective * board.getValue(index));
 	}
 
 	DEF Board::INDEX_TYPE getWeightIndex(Board::INDEX_TYPE index)
@@ -241,6 +370,7 @@ private:
     DEF void setWeights(const Board::EVALUATION_TYPE *weights)
     {
         memcpy(this->weights, weights, sizeof(Board::EVALUATION_TYPE) * 64);
+        invalidateEvalCache();
     }
 
 	DEF PlayerParams *getPlayerParams(int seed)
@@ -250,14 +380,10 @@ private:
 };
 
 template <int N_FIELDS, int N_WEIGHTS, int N_TUPLES, int TUPLES_PER_FIELD>
-class NTuplePlayer : public CpuPlayer
+class NTuplePlayer final : public CpuPlayer
 {
+	friend class CpuPlayer;
 public:
-	DEF NTuplePlayer(int seed, bool negated, UniversalLoader *loader)
-		: CpuPlayer(seed, negated), nTuples(loader->getFields(), loader->getWeights(), loader->getTuples())
-	{
-	}
-
 	DEF NTuplePlayer(int seed, bool negated, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *tuples)
 		: CpuPlayer(seed, negated), nTuples(fields, weights, tuples)
 	{
@@ -276,23 +402,80 @@ public:
     DEF void setWeights(const Board::EVALUATION_TYPE *weights)
     {
         memcpy(nTuples.getWeights(), weights, sizeof(Board::EVALUATION_TYPE) * N_WEIGHTS);
+        invalidateEvalCache();
     }
 
 	DEF PlayerParams *getPlayerParams(int seed)
 	{
-		return new NTuplePlayerParams<N_TUPLES>(seed);
+		NTuplePlayerParams<N_TUPLES> *result = new NTuplePlayerParams<N_TUPLES>(seed);
+		nTuples.initParams(result);
+		return result;
 	}
 protected:
 	// Ocena wskazanego ruchu.
-	DEF Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BOARD_ELEMENT_TYPE player, PlayerParams *p, GameData *data)
+	DEF Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, PlayerParams *p, GameData *data)
 	{
 		NTuplePlayerParams<N_TUPLES> *par = reinterpret_cast<NTuplePlayerParams<N_TUPLES> *>(p);
-		return nTuples.getValue(board, move, player, par, data);
+		return nTuples.getValue(board, move, flips, player, perspective, par, data);
 	}
 private:
 	NTuples<N_FIELDS, N_WEIGHTS, N_TUPLES, TUPLES_PER_FIELD> nTuples;
 };
 
+// Gracz oceniajacy ruchy siecia krotek o ksztalcie znanym dopiero po wczytaniu.
+class DynamicNTuplePlayer final : public CpuPlayer
+{
+	friend class CpuPlayer;
+public:
+	DEF DynamicNTuplePlayer(int seed, bool negated, int nWeights, int nTuples, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *tuples)
+		: CpuPlayer(seed, negated), nTuples(nWeights, nTuples, fields, weights, tuples)
+	{
+	}
+
+	// Tworzy gracza wspoldzielacego ksztalt sieci i wagi z podana siecia.
+	DEF DynamicNTuplePlayer(int seed, bool negated, const DynamicNTuples &nTuples)
+		: CpuPlayer(seed, negated), nTuples(nTuples)
+	{
+	}
+
+	DEF int getNWeights()
+	{
+		return nTuples.getNWeights();
+	}
+
+	DEF void getWeights(Board::EVALUATION_TYPE *weights)
+	{
+		memcpy(weights, nTuples.getWeights(), sizeof(Board::EVALUATION_TYPE) * nTuples.getNWeights());
+	}
+
+	DEF void setWeights(const Board::EVALUATION_TYPE *weights)
+	{
+		nTuples.setWeights(weights);
+		invalidateEvalCache();
+	}
+
+	DEF const DynamicNTuples &getNTuples() const
+	{
+		return nTuples;
+	}
+
+	DEF PlayerParams *getPlayerParams(int seed)
+	{
+		DynamicNTuplePlayerParams *result = new DynamicNTuplePlayerParams(seed, nTuples.getNTuples());
+		nTuples.initParams(result);
+		return result;
+	}
+protected:
+	// Ocena wskazanego ruchu.
+	DEF Board::EVALUATION_TYPE evaluateMove(Board *board, Board::INDEX_TYPE move, Board::BITBOARD_TYPE flips, Board::BOARD_ELEMENT_TYPE player, Board::BOARD_ELEMENT_TYPE perspective, PlayerParams *p, GameData *data)
+	{
+		DynamicNTuplePlayerParams *par = static_cast<DynamicNTuplePlayerParams *>(p);
+		return nTuples.getValue(board, move, flips, player, perspective, par);
+	}
+private:
+	DynamicNTuples nTuples;
+};
+
 template <int N_PLAYERS>
 class MultiPlayer : public OthelloPlayer
 {
@@ -304,6 +487,24 @@ public:
             this->players.add(players[i]);
         setNPawns(nPawns);
 	}
+    // Gracze etapow oceniaja rozne pozycje, wiec moga dzielic numer w pamieci.
+    DEF void setMoveCache(ExpertMoveCache *cache, int id)
+    {
+        for(int i = 0; i < N_PLAYERS; i++)
+            players[i]->setMoveCache(cache, id);
+    }
+
+    DEF void setEvalCache(int nEntries)
+    {
+        for(int i = 0; i < N_PLAYERS; i++)
+            players[i]->setEvalCache(nEntries);
+    }
+
+    DEF void setOpeningBook(const OpeningBook *book, int minGames)
+    {
+        for(int i = 0; i < N_PLAYERS; i++)
+            players[i]->setOpeningBook(book, minGames);
+    }
 protected:
     DEF void _setRandomMoveFreq(float value)
     {
@@ -337,7 +538,7 @@ private:
         return getIndex(nPawns, 0, N_PLAYERS - 2) + 1;
     }
 public:
-    DEF Board::INDEX_TYPE getMove(Board *board, Vector<Board::BOARD_ELEMENT_TYPE, Board::SIZE> *validMoves, Board::BOARD_ELEMENT_TYPE playerd, bool negated, PlayerParams *p, GameData *data)
+    DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerd, bool negated, PlayerParams *p, GameData *data)
     {
         int index = getPlayerIndex(board->getNPawns());
 		MultiPlayerParams<N_PLAYERS> *par = reinterpret_cast<MultiPlayerParams<N_PLAYERS> *>(p);
@@ -390,6 +591,14 @@ public:
 	    int index = getPlayerIndex(board->getNPawns());
 		return players[index]->isNegated(board);
 	}
+
+	// Gracz etapu gry wskazanej pozycji.
+	DEF CpuPlayer *getEvaluator(Board *board, PlayerParams *p, PlayerParams **evalParams)
+	{
+	    int index = getPlayerIndex(board->getNPawns());
+		MultiPlayerParams<N_PLAYERS> *par = reinterpret_cast<MultiPlayerParams<N_PLAYERS> *>(p);
+		return players[index]->getEvaluator(board, par->params[index], evalParams);
+	}
 private:
     DEF void sortNPawns()
     {
@@ -428,20 +637,68 @@ private:
 };
 
 template <int N_FIELDS, int N_WEIGHTS, int N_TUPLES, int TUPLES_PER_POS>
-DEF OthelloPlayer *check(int seed, bool negated, UniversalLoader *loader)
+DEF OthelloPlayer *check(int seed, bool negated, int nFields, int nWeights, int nTuples, int maxTuplePerPos, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *tuples)
 {
-	if (loader->getNFields() == N_FIELDS &&
-		loader->getNWeights() == N_WEIGHTS &&
-		loader->getNTuples() == N_TUPLES &&
-		loader->getMaxTuplePerPos() == TUPLES_PER_POS)
+	if (nFields == N_FIELDS &&
+		nWeights == N_WEIGHTS &&
+		nTuples == N_TUPLES &&
+		maxTuplePerPos == TUPLES_PER_POS)
 	{
-		OthelloPlayer *player = new NTuplePlayer<N_FIELDS, N_WEIGHTS, N_TUPLES, TUPLES_PER_POS>(seed, negated, loader);
+		OthelloPlayer *player = new NTuplePlayer<N_FIELDS, N_WEIGHTS, N_TUPLES, TUPLES_PER_POS>(seed, negated, fields, weights, tuples);
 		return player;
 	}
 
 	return nullptr;
 }
 
+// Z STATIC_NTUPLES tworzy NTuplePlayer z rozmiarami tablic ustalonymi w czasie
+// kompilacji dla wymienionych nizej ksztaltow sieci. W pozostalych przypadkach zwraca nullptr.
+DEF OthelloPlayer *getStaticNTuplePlayer(int seed, bool negated, int nFields, int nWeights, int nTuples, int maxTuplePerPos, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *tuples)
+{
+#ifdef STATIC_NTUPLES
+	OthelloPlayer *player = nullptr;
+	if (player == nullptr)
+		player = check<632, 6561, 120, 18>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<624, 1701, 156, 19>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<576, 8748, 96, 30>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<576, 8748, 96, 22>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<540, 648, 180, 13>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<520, 3402, 104, 16>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<488, 4698, 96, 20>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<480, 288, 240, 11>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<464, 3240, 96, 36>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<64, 192, 64, 1>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<64, 30, 64, 1>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<8, 18, 4, 3>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player == nullptr)
+		player = check<6, 9, 3, 1>(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	return player;
+#else
+	return nullptr;
+#endif //STATIC_NTUPLES
+}
+
+// Tworzy gracza dla sieci krotek o dowolnym ksztalcie.
+DEF OthelloPlayer *getNTuplePlayer(int seed, bool negated, int nFields, int nWeights, int nTuples, int maxTuplePerPos, Board::INDEX_TYPE *fields, Board::EVALUATION_TYPE *weights, int *tuples)
+{
+	OthelloPlayer *player = getStaticNTuplePlayer(seed, negated, nFields, nWeights, nTuples, maxTuplePerPos, fields, weights, tuples);
+	if (player != nullptr)
+		return player;
+
+	return new DynamicNTuplePlayer(seed, negated, nWeights, nTuples, fields, weights, tuples);
+}
+
 DEF OthelloPlayer *_getNTuplePlayer(int seed, bool negated, UniversalLoader *loader)
 {
 	OthelloPlayer *player = nullptr;
@@ -450,59 +707,8 @@ DEF OthelloPlayer *_getNTuplePlayer(int seed, bool negated, UniversalLoader *loa
 	{
 		case UniversalLoader::N_TUPLE_FORMAT:
 		{
-			player = check<632, 6561, 120, 18>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<624, 1701, 156, 19>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<576, 8748, 96, 30>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<576, 8748, 96, 22>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<540, 648, 180, 13>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<520, 3402, 104, 16>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<488, 4698, 96, 20>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<480, 288, 240, 11>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<464, 3240, 96, 36>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<64, 192, 64, 1>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<64, 30, 64, 1>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<8, 18, 4, 3>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			player = check<6, 9, 3, 1>(seed, negated, loader);
-			if (player != nullptr)
-				return player;
-
-			return nullptr;
+			return getNTuplePlayer(seed, negated, loader->getNFields(), loader->getNWeights(), loader->getNTuples(), loader->getMaxTuplePerPos(),
+				loader->getFields(), loader->getWeights(), loader->getTuples());
 		}
 		case UniversalLoader::WPC_FORMAT:
 		{
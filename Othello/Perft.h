@@ -0,0 +1,187 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "Header.h"
+#include "MailboxBoard.h"
+#include "BitBoard.h"
+#include "AnyLoader.h"
+#include "Random.h"
+#include "Watch.h"
+
+// Liczenie lisci drzewa gry (perft) oraz porownywanie implementacji planszy.
+// Zasady sa takie same jak w Othello::play: zaczynaja czarne, gracz bez ruchu
+// pasuje (pas jest osobnym polruchem), a gra konczy sie, gdy zaden z graczy
+// nie moze wykonac ruchu - koniec gry przed glebokoscia d jest lisciem.
+class Perft
+{
+public:
+	// Liczba lisci na glebokosci depth od wskazanej pozycji.
+	template <typename B>
+	DEF static uint64_t count(B &board, typename B::BOARD_ELEMENT_TYPE player, int depth, bool passed = false)
+	{
+		if (depth == 0)
+			return 1;
+
+		typename B::MOVES_TYPE moves;
+		board.validMoves(moves, player);
+		if (moves.size() == 0)
+		{
+			if (passed)
+				return 1;
+			return count(board, (typename B::BOARD_ELEMENT_TYPE)-player, depth - 1, true);
+		}
+
+		if (depth == 1)
+			return moves.size();
+
+		uint64_t nodes = 0;
+		for (int i = 0; i < moves.size(); i++)
+		{
+			board.makeMove(moves[i], moves.getFlips(i), player);
+			nodes += count(board, (typename B::BOARD_ELEMENT_TYPE)-player, depth - 1);
+			board.undoMove(moves[i], moves.getFlips(i), player);
+		}
+		return nodes;
+	}
+
+	// Wypisuje perft 1..maxDepth od pozycji poczatkowej, a jesli podano plansze,
+	// sume lisci na glebokosci maxDepth ze wszystkich plansz (ruch czarnych).
+	template <typename B>
+	DEF static void run(int maxDepth, BoardLoader *boards)
+	{
+		for (int depth = 1; depth <= maxDepth; depth++)
+		{
+			B board;
+			Watch<double> watch;
+			uint64_t nodes = count(board, B::BLACK, depth);
+			print("start", depth, nodes, watch.stop());
+		}
+
+		if (boards == nullptr)
+			return;
+
+		uint64_t nodes = 0;
+		Watch<double> watch;
+		for (int i = 0; i < boards->getNBoards(); i++)
+		{
+			B board(reinterpret_cast<typename B::BOARD_ELEMENT_TYPE *>(boards->getBoardValues(i)));
+			nodes += count(board, B::BLACK, maxDepth);
+		}
+		print("boards", maxDepth, nodes, watch.stop());
+	}
+
+	// Rozgrywa nGames losowych gier rownolegle na planszy wzorcowej R i badanej C
+	// i zglasza pierwsza roznice: liste ruchow, przejmowane piony, stan planszy
+	// i jego skrot po ruchu lub wynik gry. Zwraca liczbe rozegranych zgodnie gier.
+	template <typename R, typename C>
+	DEF static int compare(int nGames, int seed, BoardLoader *boards = nullptr)
+	{
+		Random<int> random(seed);
+		typename R::MOVES_TYPE refMoves;
+		typename C::MOVES_TYPE moves;
+		uint64_t nMoves = 0;
+		Watch<double> watch;
+
+		for (int game = 0; game < nGames; game++)
+		{
+			R ref;
+			C board;
+			if (boards != nullptr && boards->getNBoards() > 0)
+			{
+				Board::BOARD_ELEMENT_TYPE *values = boards->getBoardValues(game % boards->getNBoards());
+				ref.setValues(reinterpret_cast<typename R::BOARD_ELEMENT_TYPE *>(values));
+				board.setValues(reinterpret_cast<typename C::BOARD_ELEMENT_TYPE *>(values));
+			}
+
+			int ply = 0;
+			bool aMoveWasPossible;
+			do
+			{
+				aMoveWasPossible = false;
+				for (int p = 0; p < 2; p++, ply++)
+				{
+					typename R::BOARD_ELEMENT_TYPE player = p == 0 ? R::BLACK : R::WHITE;
+					ref.validMoves(refMoves, player);
+					board.validMoves(moves, player);
+					if (!sameMoves(refMoves, moves))
+					{
+						report(game, ply, "move list", ref, board, refMoves, moves);
+						return game;
+					}
+					if (refMoves.size() == 0)
+						continue;
+
+					int m = random.getValue(refMoves.size());
+					int j = moves.find(refMoves[m]);
+					// plansza wzorcowa wyznacza przejmowane piony od nowa (simulateMove)
+					ref.makeMove(refMoves[m], player);
+					board.makeMove(moves[j], moves.getFlips(j), player);
+					nMoves++;
+					if (ref.getPawns(R::BLACK) != board.getPawns(C::BLACK) || ref.getPawns(R::WHITE) != board.getPawns(C::WHITE) || ref.getNPawns() != board.getNPawns())
+					{
+						report(game, ply, "position after move", ref, board, refMoves, moves);
+						return game;
+					}
+					if (ref.getHash(player) != board.getHash(player) || ref.getHash(R::BLACK) != ref.computeHash() || board.getHash(C::BLACK) != board.computeHash())
+					{
+						report(game, ply, "hash after move", ref, board, refMoves, moves);
+						return game;
+					}
+					aMoveWasPossible = true;
+				}
+			}
+			while (aMoveWasPossible);
+
+			if (ref.result().item1 != board.result().item1 || ref.result().item2 != board.result().item2)
+			{
+				report(game, ply, "game result", ref, board, refMoves, moves);
+				return game;
+			}
+		}
+
+		double time = watch.stop();
+		printf("No divergence: %d games, %llu moves, %f s\n", nGames, (unsigned long long)nMoves, time);
+		return nGames;
+	}
+private:
+	DEF static void print(const char *from, int depth, uint64_t nodes, double time)
+	{
+		printf("perft %s depth %d nodes %llu time %f s Mnps %f\n", from, depth, (unsigned long long)nodes, time,
+			time > 0 ? nodes / time / 1e6 : 0.0);
+	}
+
+	// Porownuje listy ruchow niezaleznie od kolejnosci.
+	template <typename M1, typename M2>
+	DEF static bool sameMoves(const M1 &moves1, const M2 &moves2)
+	{
+		if (moves1.size() != moves2.size())
+			return false;
+		for (int i = 0; i < moves1.size(); i++)
+		{
+			int j = moves2.find(moves1[i]);
+			if (j < 0 || moves2[j] != moves1[i] || moves2.getFlips(j) != moves1.getFlips(i))
+				return false;
+		}
+		return true;
+	}
+
+	template <typename R, typename C>
+	DEF static void report(int game, int ply, const char *what, R &ref, C &board, const typename R::MOVES_TYPE &refMoves, const typename C::MOVES_TYPE &moves)
+	{
+		printf("Divergence in game %d, ply %d: %s\n", game, ply, what);
+		printf("Reference moves:");
+		for (int i = 0; i < refMoves.size(); i++)
+			printf(" %d/%llx", (int)refMoves[i], (unsigned long long)refMoves.getFlips(i));
+		printf("\nCandidate moves:");
+		for (int i = 0; i < moves.size(); i++)
+			printf(" %d/%llx", (int)moves[i], (unsigned long long)moves.getFlips(i));
+		printf("\nReference board:\n");
+		ref.print();
+		printf("Candidate board:\n");
+		board.print();
+	}
+};
+
+#endif //PERFT_H
@@ -4,19 +4,40 @@
 #include "Header.h"
 #include "Random.h"
 #include "Board.h"
+#include "SparseSet.h"
+#include "AlignedArray.h"
+#include "EvalCache.h"
 
 class PlayerParams
 {
 public:
 	DEF PlayerParams(int seed)
-		: rand(seed) { }
+		: rand(seed), evalCache(nullptr) { }
 
 	DEF virtual ~PlayerParams()
 	{
+		delete evalCache;
+	}
+
+	// Ustawia ziarno generatora, od ktorego zaczyna sie kolejna gra.
+	DEF virtual void setSeed(int seed)
+	{
+		rand = Random<int>(seed);
+	}
+
+	// Dodaje statystyki pamieci ocen gracza (i graczy skladowych).
+	DEF virtual void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		if (evalCache == nullptr)
+			return;
+		*hits += evalCache->getHits();
+		*misses += evalCache->getMisses();
 	}
 
 	Random<int> rand;
 	Vector<Board::INDEX_TYPE, Board::SIZE> bestMoves;
+	// Pamiec ocen ruchow tworzona przez gracza, gdy ja wlaczono (nullptr - brak).
+	EvalCache *evalCache;
 };
 
 template<int N_TUPLES>
@@ -27,6 +48,35 @@ public:
 		PlayerParams(seed) { }
 
 	SparseSet<unsigned short, N_TUPLES, N_TUPLES> indexes;
+	// Zmiany indeksow krotek dotknietych ocenianym ruchem.
+	int deltas[N_TUPLES];
+	// Indeksy krotek (z perspektywy czarnych) dla planszy opisanej przez pawns.
+	int tupleIndexes[N_TUPLES];
+	// Piony czarne i biale na planszy, dla ktorej wyznaczono tupleIndexes.
+	Board::BITBOARD_TYPE pawns[2];
+};
+
+// Stan gry gracza DynamicNTuplePlayer - odpowiednik NTuplePlayerParams
+// dla sieci krotek o liczbie krotek znanej dopiero po wczytaniu.
+class DynamicNTuplePlayerParams : public PlayerParams
+{
+public:
+	DEF DynamicNTuplePlayerParams(int seed, int nTuples) :
+		PlayerParams(seed), touched(nTuples), isTouched(nTuples), deltas(nTuples), tupleIndexes(nTuples)
+	{
+		nTouched = 0;
+	}
+
+	// Krotki dotkniete ocenianym ruchem, w kolejnosci dodawania.
+	AlignedArray<int> touched;
+	int nTouched;
+	AlignedArray<unsigned char> isTouched;
+	// Zmiany indeksow krotek dotknietych ocenianym ruchem.
+	AlignedArray<int> deltas;
+	// Indeksy krotek (z perspektywy czarnych) dla planszy opisanej przez pawns.
+	AlignedArray<int> tupleIndexes;
+	// Piony czarne i biale na planszy, dla ktorej wyznaczono tupleIndexes.
+	Board::BITBOARD_TYPE pawns[2];
 };
 
 template<int N_PLAYERS>
@@ -42,6 +92,20 @@ public:
 			delete params[i];
 	}
 
+	DEF void setSeed(int seed)
+	{
+		PlayerParams::setSeed(seed);
+		for(int i = 0; i < params.size(); i++)
+			params[i]->setSeed(rand.rand());
+	}
+
+	DEF void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		PlayerParams::addEvalCacheStats(hits, misses);
+		for(int i = 0; i < params.size(); i++)
+			params[i]->addEvalCacheStats(hits, misses);
+	}
+
 	Vector<PlayerParams *, N_PLAYERS> params;
 };
 
@@ -50,7 +114,6 @@ class GameData
 public:
     DEF GameData() { }
 
-	Board tmpBoard;
 	SparseSet<Board::BOARD_ELEMENT_TYPE, Board::SIZE, Board::MAX_CH_POS> positions;
 };
 
@@ -0,0 +1,716 @@
+#ifndef SEARCH_PLAYER_H
+#define SEARCH_PLAYER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifndef NOT_TH
+#include <thread>
+#include <atomic>
+#endif // NOT_TH
+#include "Header.h"
+#include "Board.h"
+#include "PlayerParams.h"
+#include "OthelloPlayer.h"
+#include "ExpertMoveCache.h"
+#include "AnyLoader.h"
+#include "Random.h"
+#include "Watch.h"
+
+// Tablica transpozycji wspolna dla watkow przeszukujacych te sama pozycje korzenia.
+// Wpis to dwa slowa 64-bitowe: dane oraz skrot pozycji xor dane, zapisywane bez blokad.
+// Wpis rozerwany przez rownoczesny zapis nie przechodzi kontroli skrotu i jest pomijany.
+// Oceny sa wzgledne wzgledem korzenia, wiec wazne sa tylko wpisy biezacego przeszukiwania:
+// wpis zawiera 17-bitowy numer przeszukiwania, a po jego przepelnieniu tablica jest czyszczona.
+class SearchTable
+{
+public:
+	// Liczba bitow glebokosci we wpisie (glebokosc < 32).
+	static const int DEPTH_BITS = 5;
+	// Liczba bitow numeru przeszukiwania we wpisie.
+	static const int GENERATION_BITS = 17;
+
+	// Rodzaj oceny we wpisie.
+	enum Bound
+	{
+		EXACT,
+		LOWER,
+		UPPER
+	};
+
+	struct Entry
+	{
+		Board::EVALUATION_TYPE value;
+		int depth;
+		int bound;
+		Board::INDEX_TYPE move;
+	};
+
+	DEF SearchTable(int nEntries)
+	{
+		size = 1;
+		while (size < nEntries)
+			size <<= 1;
+		slots.resize(size);
+		generation = 0;
+		for (int i = 0; i < size; i++)
+		{
+			slots[i].check = 0;
+			slots[i].data = 0;
+		}
+	}
+
+	// Rozpoczyna nowe przeszukiwanie - uniewaznia wszystkie wpisy.
+	DEF void newSearch()
+	{
+		generation = (generation + 1) & ((1 << GENERATION_BITS) - 1);
+		// numer 0 maja puste wpisy, a wpisy sprzed przepelnienia moglyby zostac uznane za biezace
+		if (generation == 0)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				slots[i].check = 0;
+				slots[i].data = 0;
+			}
+			generation = 1;
+		}
+	}
+
+	DEF bool probe(Board::HASH_TYPE key, Entry &entry)
+	{
+		Slot &slot = slots[(int)(key & (size - 1))];
+		uint64_t data = slot.data;
+		if ((slot.check ^ data) != key || (int)(data >> (64 - GENERATION_BITS)) != generation)
+			return false;
+		uint32_t bits = (uint32_t)data;
+		memcpy(&entry.value, &bits, sizeof(bits));
+		entry.move = (Board::INDEX_TYPE)(data >> 32 & 0xFF);
+		entry.depth = (int)(data >> 40 & ((1 << DEPTH_BITS) - 1));
+		entry.bound = (int)(data >> (40 + DEPTH_BITS) & 3);
+		return true;
+	}
+
+	DEF void store(Board::HASH_TYPE key, Board::EVALUATION_TYPE value, int depth, int bound, Board::INDEX_TYPE move)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		uint64_t data = bits | (uint64_t)(unsigned char)move << 32 | (uint64_t)(depth & ((1 << DEPTH_BITS) - 1)) << 40
+			| (uint64_t)(bound & 3) << (40 + DEPTH_BITS) | (uint64_t)generation << (64 - GENERATION_BITS);
+		Slot &slot = slots[(int)(key & (size - 1))];
+		slot.check = key ^ data;
+		slot.data = data;
+	}
+private:
+	struct Slot
+	{
+#ifndef NOT_TH
+		std::atomic<uint64_t> check;
+		std::atomic<uint64_t> data;
+
+		Slot() { }
+
+		Slot(const Slot &other) : check(other.check.load()), data(other.data.load()) { }
+#else
+		uint64_t check;
+		uint64_t data;
+#endif // NOT_TH
+	};
+
+	int size;
+	int generation;
+	std::vector<Slot> slots;
+};
+
+// Stan przeszukiwania gracza SearchPlayer w jednej grze: parametry gracza
+// oceniajacego, listy ruchow i ich oceny na kolejnych poziomach drzewa
+// oraz tablica najlepszych ruchow z poprzednich iteracji.
+class SearchPlayerParams : public PlayerParams
+{
+public:
+	// Najwieksza liczba polruchow (wraz z pasami) od korzenia.
+	static const int MAX_PLY = 64;
+	// Liczba wpisow tablicy najlepszych ruchow (potega 2).
+	static const int N_BEST_MOVES = 4096;
+
+	// Najlepszy ruch znaleziony w pozycji o skrocie key.
+	struct BestMove
+	{
+		Board::HASH_TYPE key;
+		// Numer przeszukiwania, w ktorym zapisano wpis.
+		unsigned search;
+		Board::INDEX_TYPE move;
+	};
+
+	DEF SearchPlayerParams(int seed, PlayerParams *params) :
+		PlayerParams(seed), params(params), bestMoveTable(N_BEST_MOVES)
+	{
+		for (int i = 0; i < N_BEST_MOVES; i++)
+			bestMoveTable[i].search = 0;
+		search = 0;
+		nodes = 0;
+		aborted = false;
+		evaluator = nullptr;
+		evalParams = nullptr;
+		data = nullptr;
+		perspective = Board::BLACK;
+		table = nullptr;
+#ifndef NOT_TH
+		stop = nullptr;
+#endif // NOT_TH
+	}
+
+	DEF ~SearchPlayerParams()
+	{
+		delete params;
+		// tablica watkow pomocniczych nalezy do watku glownego
+		for (size_t i = 0; i < helpers.size(); i++)
+		{
+			helpers[i]->table = nullptr;
+			delete helpers[i];
+		}
+		delete table;
+	}
+
+	DEF void setSeed(int seed)
+	{
+		PlayerParams::setSeed(seed);
+		if (params != nullptr)
+			params->setSeed(rand.rand());
+	}
+
+	DEF void addEvalCacheStats(int64_t *hits, int64_t *misses)
+	{
+		PlayerParams::addEvalCacheStats(hits, misses);
+		if (params != nullptr)
+			params->addEvalCacheStats(hits, misses);
+	}
+
+	// Parametry przeszukiwanego gracza.
+	PlayerParams *params;
+	// Stan watkow pomocniczych przeszukiwania rownoleglego i wspolna tablica
+	// transpozycji (tworzone przy pierwszym takim przeszukiwaniu).
+	std::vector<SearchPlayerParams *> helpers;
+	SearchTable *table;
+	// Dane gry watku pomocniczego.
+	GameData helperData;
+	Board::MOVES_TYPE moves[MAX_PLY];
+	// Oceny pozycji po kazdym ruchu z listy, z perspektywy wykonujacego ruch.
+	Board::EVALUATION_TYPE values[MAX_PLY][Board::MAX_CH_POS];
+	AlignedArray<BestMove> bestMoveTable;
+
+	// Biezace przeszukiwanie.
+	unsigned search;
+	int64_t nodes;
+	bool aborted;
+	CpuPlayer *evaluator;
+	PlayerParams *evalParams;
+	GameData *data;
+	Board::BOARD_ELEMENT_TYPE perspective;
+	Watch<double> watch;
+#ifndef NOT_TH
+	// Sygnal zakonczenia przeszukiwania rownoleglego (nullptr - brak).
+	std::atomic<bool> *stop;
+#endif // NOT_TH
+};
+
+// Gracz wybierajacy ruch przeszukiwaniem alfa-beta (negamax) z iteracyjnym poglebianiem.
+// Liscie ocenia gracz CpuPlayer wskazany przez opakowanego gracza dla pozycji korzenia
+// (MultiPlayer wybiera gracza etapu gry). Ocena liscia to suma zmian oceny
+// (evaluateMove) wzdluz sciezki od korzenia, wiec drzewo przechodzone jest
+// wykonywaniem i cofaniem ruchow (makeMove/undoMove), bez kopiowania planszy.
+// Ruchy porzadkowane sa wedlug najlepszego ruchu z poprzedniej iteracji,
+// a nastepnie wedlug oceny pozycji po ruchu.
+// Przeszukiwanie konczy sie po glebokosci maxDepth, po ocenieniu maxNodes pozycji
+// lub po maxTime sekundach (0 - bez limitu); wynik przerwanej iteracji jest pomijany.
+// Limit liczby pozycji zamiast czasu sprawia, ze wybor ruchu nie zalezy od obciazenia maszyny.
+// Glebokosc 1 odpowiada opakowanemu graczowi.
+// Dla nThreads > 1 pozycje przeszukuje rownolegle nThreads watkow ze wspolna tablica
+// transpozycji (Lazy SMP): ruch wybiera watek glowny, a pomocnicze przeszukuja czesc
+// iteracji o jeden polruch glebiej i w innej kolejnosci ruchow w korzeniu, wypelniajac
+// tablice. Limity liczby pozycji i czasu dotycza kazdego watku. Wynik przeszukiwania
+// rownoleglego zalezy od przeplotu watkow, wiec gry nie sa wtedy powtarzalne.
+// Watki tworzone sa przy kazdym ruchu (poza pula ThreadPool, ktora moze wykonywac
+// gre wywolujaca getMove).
+class SearchPlayer : public OthelloPlayer
+{
+public:
+	// Najwieksza glebokosc przeszukiwania.
+	static const int MAX_DEPTH = 30;
+	static_assert(MAX_DEPTH < (1 << SearchTable::DEPTH_BITS), "glebokosc nie miesci sie we wpisie tablicy transpozycji");
+
+	// Liczba wpisow wspolnej tablicy transpozycji przeszukiwania rownoleglego.
+	static const int N_TABLE_ENTRIES = 1 << 20;
+
+	// player - gracz oceniajacy pozycje, usuwany wraz z obiektem.
+	DEF SearchPlayer(OthelloPlayer *player, int maxDepth, int64_t maxNodes, int nThreads = 1, double maxTime = 0)
+		: OthelloPlayer()
+	{
+		this->player = player;
+		this->maxDepth = std::min(std::max(maxDepth, 1), MAX_DEPTH);
+		this->maxNodes = maxNodes;
+		this->nThreads = std::max(nThreads, 1);
+		this->maxTime = maxTime;
+		moveCache = nullptr;
+		moveCacheId = 0;
+		useTable = false;
+	}
+
+	DEF ~SearchPlayer()
+	{
+		delete player;
+	}
+
+	DEF Board::INDEX_TYPE getMove(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, PlayerParams *p, GameData *data)
+	{
+		SearchPlayerParams *par = static_cast<SearchPlayerParams *>(p);
+		PlayerParams *evalParams = nullptr;
+		CpuPlayer *evaluator = player->getEvaluator(board, par->params, &evalParams);
+		if (evaluator == nullptr || maxDepth <= 1)
+			return player->getMove(board, validMoves, playerColor, negated, par->params, data);
+
+		PHASE_TIMER(EVALUATION);
+		int cacheId = 2 * moveCacheId + (negated ? 1 : 0);
+		if (moveCache == nullptr || !moveCache->get(cacheId, board->getHash(playerColor), validMoves, par->bestMoves))
+		{
+			par->evaluator = evaluator;
+			par->evalParams = evalParams;
+			par->data = data;
+			// jak w CpuPlayer::getMove - negowany gracz ocenia plansze z perspektywy czarnych
+			par->perspective = negated ? Board::BLACK : playerColor;
+			if (nThreads > 1 || useTable)
+				searchParallel(board, validMoves, playerColor, negated, par);
+			else
+				searchRoot(board, validMoves, playerColor, negated ? -1.0f : 1.0f, par, 0);
+			if (moveCache != nullptr)
+				moveCache->put(cacheId, board->getHash(playerColor), validMoves, par->bestMoves);
+		}
+
+		switch (par->bestMoves.size())
+		{
+		case 0:
+			printf("Invalid game state - player has no moves.\n");
+			exit(0);
+			return -1;
+		case 1:
+			return par->bestMoves[0];
+		default:
+#ifdef MIN_MOVE
+			Board::INDEX_TYPE min = 101;
+			for (int i = 0; i < par->bestMoves.size(); i++)
+				if (min > par->bestMoves[i])
+					min = par->bestMoves[i];
+			return min;
+#else
+			return par->bestMoves[par->rand.getValue(par->bestMoves.size())];
+#endif
+		}
+	}
+
+	DEF bool isNegated(Board *board)
+	{
+		return player->isNegated(board);
+	}
+
+	DEF int getNWeights()
+	{
+		return player->getNWeights();
+	}
+
+	DEF void getWeights(Board::EVALUATION_TYPE *weights)
+	{
+		player->getWeights(weights);
+	}
+
+	DEF void setWeights(const Board::EVALUATION_TYPE *weights)
+	{
+		player->setWeights(weights);
+	}
+
+	DEF PlayerParams *getPlayerParams(int seed)
+	{
+		return new SearchPlayerParams(seed, player->getPlayerParams(seed));
+	}
+
+	// Wynik przeszukiwania zalezy tylko od pozycji, wiec mozna go zapamietac.
+	DEF void setMoveCache(ExpertMoveCache *cache, int id)
+	{
+		moveCache = cache;
+		moveCacheId = id;
+	}
+
+	DEF void setEvalCache(int nEntries)
+	{
+		player->setEvalCache(nEntries);
+	}
+
+	// Przeszukiwanie jednym watkiem korzysta z tablicy transpozycji jak rownolegle.
+	DEF void setUseTable(bool useTable)
+	{
+		this->useTable = useTable;
+	}
+
+	DEF void setOpeningBook(const OpeningBook *book, int minGames)
+	{
+		player->setOpeningBook(book, minGames);
+	}
+
+	DEF int getMaxDepth()
+	{
+		return maxDepth;
+	}
+
+	DEF int64_t getMaxNodes()
+	{
+		return maxNodes;
+	}
+
+	// Liczba pozycji ocenionych przez wszystkie watki w ostatnim przeszukiwaniu.
+	DEF static int64_t getNodes(PlayerParams *p)
+	{
+		SearchPlayerParams *par = static_cast<SearchPlayerParams *>(p);
+		int64_t nodes = par->nodes;
+		for (size_t i = 0; i < par->helpers.size(); i++)
+			nodes += par->helpers[i]->nodes;
+		return nodes;
+	}
+
+	// Przeszukuje do glebokosci depth pozycje srodka gry (nPlies losowych ruchow od plansz
+	// z pliku) kolejno na 1, 2, 4, ... maxThreads watkach i wypisuje czas,
+	// liczbe ocenionych pozycji oraz przyspieszenie wzgledem jednego watku.
+	// Kazde przeszukiwanie, rowniez jednym watkiem, korzysta z tablicy transpozycji.
+	static void benchmark(const std::string &playerFile, int depth, int maxThreads, BoardLoader *boards, int nPositions, int nPlies, int seed)
+	{
+		std::vector<Board> positions;
+		std::vector<Board::BOARD_ELEMENT_TYPE> colors;
+		Random<int> random(seed);
+		Board::MOVES_TYPE moves;
+		for (int b = 0; (int)positions.size() < nPositions && b < 100 * nPositions; b++)
+		{
+			Board board;
+			if (boards != nullptr && boards->getNBoards() > 0)
+				board.setValues(boards->getBoardValues(b % boards->getNBoards()));
+			Board::BOARD_ELEMENT_TYPE color = Board::BLACK;
+			for (int i = 0; i < nPlies; i++, color = -color)
+			{
+				board.validMoves(moves, color);
+				if (moves.size() > 0)
+				{
+					int m = random.getValue(moves.size());
+					board.makeMove(moves[m], moves.getFlips(m), color);
+				}
+			}
+			board.validMoves(moves, color);
+			if (moves.size() > 1)
+			{
+				positions.push_back(board);
+				colors.push_back(color);
+			}
+		}
+
+		double baseTime = 0;
+		for (int threads = 1; ; threads = std::min(2 * threads, maxThreads))
+		{
+			OthelloPlayer *evaluator = OthelloPlayer::getPlayer(playerFile, seed, false);
+			if (evaluator == nullptr)
+				return;
+			SearchPlayer player(evaluator, depth, 0, threads);
+			player.setUseTable(true);
+			PlayerParams *params = player.getPlayerParams(seed);
+			GameData data;
+			int64_t nodes = 0;
+			int checksum = 0;
+			Watch<double> watch;
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				Board board(positions[i]);
+				board.validMoves(moves, colors[i]);
+				checksum += player.getMove(&board, &moves, colors[i], false, params, &data);
+				nodes += getNodes(params);
+			}
+			double time = watch.stop();
+			if (threads == 1)
+				baseTime = time;
+			printf("smp threads %d depth %d positions %d time %f s nodes %lld Mnps %f speedup %f checksum %d\n", threads, depth, (int)positions.size(),
+				time, (long long)nodes, time > 0 ? nodes / time / 1e6 : 0.0, time > 0 ? baseTime / time : 0.0, checksum);
+			fflush(stdout);
+			delete params;
+			if (threads >= maxThreads)
+				break;
+		}
+	}
+private:
+	// Ocena wygranej gry (powiekszana o przewage pionow).
+	static constexpr Board::EVALUATION_TYPE WIN_VALUE = 10000000.0f;
+
+	OthelloPlayer *player;
+	int maxDepth;
+	int64_t maxNodes;
+	int nThreads;
+	double maxTime;
+	ExpertMoveCache *moveCache;
+	int moveCacheId;
+	bool useTable;
+
+	DEF static Board::EVALUATION_TYPE infinity()
+	{
+		return std::numeric_limits<Board::EVALUATION_TYPE>::max();
+	}
+
+	// Zmiana oceny pozycji po ruchu z perspektywy wykonujacego ruch.
+	// sideFactor - znak zamieniajacy ocene evaluatora na perspektywe wykonujacego ruch.
+	DEF Board::EVALUATION_TYPE evaluate(Board *board, Board::MOVES_TYPE &moves, int i, Board::BOARD_ELEMENT_TYPE player, Board::EVALUATION_TYPE sideFactor, SearchPlayerParams *par)
+	{
+		return sideFactor * par->evaluator->evaluateMove(board, moves[i], moves.getFlips(i), player, par->perspective, par->evalParams, par->data);
+	}
+
+	// Sprawdza, czy przeszukiwanie nalezy przerwac.
+	DEF bool isOutOfBudget(SearchPlayerParams *par)
+	{
+		if (maxNodes > 0 && par->nodes >= maxNodes)
+			return true;
+		if (maxTime > 0 && par->watch.current() >= maxTime)
+			return true;
+#ifndef NOT_TH
+		if (par->stop != nullptr && par->stop->load(std::memory_order_relaxed))
+			return true;
+#endif // NOT_TH
+		return false;
+	}
+
+	// Przeszukiwanie Lazy SMP: watek wywolujacy przeszukuje pozycje jak searchRoot,
+	// a nThreads - 1 watkow pomocniczych przeszukuje kopie planszy, dzielac z nim tablice.
+	DEF void searchParallel(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE playerColor, bool negated, SearchPlayerParams *par)
+	{
+		Board::EVALUATION_TYPE sideFactor = negated ? -1.0f : 1.0f;
+#ifndef NOT_TH
+		if (par->table == nullptr)
+			par->table = new SearchTable(N_TABLE_ENTRIES);
+		while ((int)par->helpers.size() < nThreads - 1)
+			par->helpers.push_back(new SearchPlayerParams(par->rand.rand(), player->getPlayerParams(par->rand.rand())));
+		par->table->newSearch();
+
+		// kopie planszy powstaja przed rozpoczeciem przeszukiwania przez watek glowny
+		std::vector<Board> boards(nThreads - 1, *board);
+		std::atomic<bool> stop(false);
+		std::vector<std::thread> threads;
+		for (int h = 0; h < nThreads - 1; h++)
+		{
+			SearchPlayerParams *helper = par->helpers[h];
+			helper->evaluator = player->getEvaluator(board, helper->params, &helper->evalParams);
+			helper->data = &helper->helperData;
+			helper->perspective = par->perspective;
+			helper->table = par->table;
+			helper->stop = &stop;
+			threads.push_back(std::thread([this, &boards, validMoves, playerColor, sideFactor, helper, h]()
+			{
+				Board::MOVES_TYPE moves(*validMoves);
+				searchRoot(&boards[h], &moves, playerColor, sideFactor, helper, h + 1);
+			}));
+		}
+		searchRoot(board, validMoves, playerColor, sideFactor, par, 0);
+		stop = true;
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+#else
+		searchRoot(board, validMoves, playerColor, sideFactor, par, 0);
+#endif // NOT_TH
+	}
+
+	// Iteracyjne poglebianie w korzeniu. Wypelnia par->bestMoves ruchami o najlepszej
+	// ocenie z ostatniej ukonczonej iteracji.
+	// helper - numer watku pomocniczego przeszukiwania rownoleglego (0 - watek glowny).
+	DEF void searchRoot(Board *board, Board::MOVES_TYPE *validMoves, Board::BOARD_ELEMENT_TYPE player, Board::EVALUATION_TYPE sideFactor, SearchPlayerParams *par, int helper)
+	{
+		int nMoves = validMoves->size();
+		// oceny pozycji po ruchach (glebokosc 1) i wyniki ostatniej ukonczonej iteracji
+		Board::EVALUATION_TYPE *deltas = par->values[0];
+		Board::EVALUATION_TYPE scores[Board::MAX_CH_POS];
+		Board::EVALUATION_TYPE newScores[Board::MAX_CH_POS];
+		int order[Board::MAX_CH_POS];
+
+		par->search++;
+		par->nodes = nMoves;
+		par->aborted = false;
+		par->watch.start();
+		for (int i = 0; i < nMoves; i++)
+		{
+			deltas[i] = evaluate(board, *validMoves, i, player, sideFactor, par);
+			scores[i] = deltas[i];
+			order[i] = i;
+		}
+
+		for (int depth = 2; depth <= maxDepth; depth++)
+		{
+			if (isOutOfBudget(par))
+				break;
+
+			// najpierw ruchy najlepsze w poprzedniej iteracji
+			for (int i = 1; i < nMoves; i++)
+			{
+				int key = order[i];
+				int j = i - 1;
+				while (j >= 0 && scores[order[j]] < scores[key])
+				{
+					order[j + 1] = order[j];
+					j--;
+				}
+				order[j + 1] = key;
+			}
+			// watki pomocnicze zaczynaja od innych ruchow i co druga iteracje ida glebiej
+			int searchDepth = depth;
+			if (helper > 0)
+			{
+				std::rotate(order, order + helper % nMoves, order + nMoves);
+				if (helper % 2 == 1)
+					searchDepth = std::min(depth + 1, maxDepth);
+			}
+
+			// okno obejmuje ruchy rowne najlepszemu, wiec remisy znane sa dokladnie
+			Board::EVALUATION_TYPE best = -infinity();
+			for (int k = 0; k < nMoves && !par->aborted; k++)
+			{
+				int i = order[k];
+				Board::EVALUATION_TYPE alpha = k == 0 ? -infinity() : best - (Board::EVALUATION_TYPE)EPS_VALUE;
+				board->makeMove((*validMoves)[i], validMoves->getFlips(i), player);
+				newScores[i] = -negamax(board, -player, searchDepth - 1, -infinity(), -alpha, -deltas[i], -sideFactor, 1, false, par);
+				board->undoMove((*validMoves)[i], validMoves->getFlips(i), player);
+				best = std::max(best, newScores[i]);
+			}
+			if (par->aborted)
+				break;
+
+			for (int i = 0; i < nMoves; i++)
+				scores[i] = newScores[i];
+		}
+
+		Board::EVALUATION_TYPE best = scores[0];
+		for (int i = 1; i < nMoves; i++)
+			best = std::max(best, scores[i]);
+		par->bestMoves.clear();
+		for (int i = 0; i < nMoves; i++)
+		{
+			if (scores[i] == best || std::abs(scores[i] - best) < EPS_VALUE)
+				par->bestMoves.add((*validMoves)[i]);
+		}
+	}
+
+	// Ocena pozycji z perspektywy gracza player (fail-soft).
+	// score - ocena pozycji z perspektywy gracza player wzgledem korzenia,
+	// passed - poprzedni gracz spasowal.
+	DEF Board::EVALUATION_TYPE negamax(Board *board, Board::BOARD_ELEMENT_TYPE player, int depth, Board::EVALUATION_TYPE alpha, Board::EVALUATION_TYPE beta,
+		Board::EVALUATION_TYPE score, Board::EVALUATION_TYPE sideFactor, int ply, bool passed, SearchPlayerParams *par)
+	{
+		if (depth == 0)
+			return score;
+
+		Board::MOVES_TYPE &moves = par->moves[ply];
+		board->validMoves(moves, player);
+		int nMoves = moves.size();
+		if (nMoves == 0)
+		{
+			if (passed)
+				return getFinalValue(board, player);
+			// pas nie zmienia planszy ani glebokosci
+			return -negamax(board, -player, depth, -beta, -alpha, -score, -sideFactor, ply + 1, true, par);
+		}
+
+		Board::HASH_TYPE hash = board->getHash(player);
+		int first = -1;
+		if (par->table != nullptr && depth > 1)
+		{
+			SearchTable::Entry stored;
+			if (par->table->probe(hash, stored))
+			{
+				if (stored.depth >= depth && (stored.bound == SearchTable::EXACT
+					|| (stored.bound == SearchTable::LOWER && stored.value >= beta)
+					|| (stored.bound == SearchTable::UPPER && stored.value <= alpha)))
+					return stored.value;
+				first = moves.find(stored.move);
+			}
+		}
+
+		Board::EVALUATION_TYPE *values = par->values[ply];
+		Board::EVALUATION_TYPE best = -infinity();
+		for (int i = 0; i < nMoves; i++)
+		{
+			values[i] = score + evaluate(board, moves, i, player, sideFactor, par);
+			best = std::max(best, values[i]);
+		}
+		par->nodes += nMoves;
+		if (depth == 1)
+			return best;
+		if (isOutOfBudget(par))
+		{
+			par->aborted = true;
+			return best;
+		}
+
+		SearchPlayerParams::BestMove &entry = par->bestMoveTable[(int)(hash & (SearchPlayerParams::N_BEST_MOVES - 1))];
+		if (first < 0 && entry.search == par->search && entry.key == hash)
+			first = moves.find(entry.move);
+		Board::EVALUATION_TYPE alphaBegin = alpha;
+
+		int order[Board::MAX_CH_POS];
+		for (int i = 0; i < nMoves; i++)
+			order[i] = i;
+
+		best = -infinity();
+		int bestIndex = 0;
+		for (int k = 0; k < nMoves; k++)
+		{
+			// kolejny ruch: najlepszy z poprzedniej iteracji, potem najlepiej oceniony
+			int selected = k;
+			for (int j = k + 1; j < nMoves; j++)
+			{
+				if (order[selected] == first)
+					break;
+				if (order[j] == first || values[order[j]] > values[order[selected]])
+					selected = j;
+			}
+			std::swap(order[k], order[selected]);
+			int i = order[k];
+
+			board->makeMove(moves[i], moves.getFlips(i), player);
+			Board::EVALUATION_TYPE value = -negamax(board, -player, depth - 1, -beta, -alpha, -values[i], -sideFactor, ply + 1, false, par);
+			board->undoMove(moves[i], moves.getFlips(i), player);
+			if (par->aborted)
+				return value;
+
+			if (value > best)
+			{
+				best = value;
+				bestIndex = i;
+				if (value > alpha)
+					alpha = value;
+				if (alpha >= beta)
+					break;
+			}
+		}
+
+		entry.key = hash;
+		entry.search = par->search;
+		entry.move = moves[bestIndex];
+		if (par->table != nullptr)
+		{
+			int bound = best <= alphaBegin ? SearchTable::UPPER : best >= beta ? SearchTable::LOWER : SearchTable::EXACT;
+			par->table->store(hash, best, depth, bound, moves[bestIndex]);
+		}
+		return best;
+	}
+
+	// Ocena zakonczonej gry z perspektywy gracza player.
+	DEF static Board::EVALUATION_TYPE getFinalValue(Board *board, Board::BOARD_ELEMENT_TYPE player)
+	{
+		Tuple<int, int> counts = board->counts();
+		int diff = player == Board::BLACK ? counts.item1 - counts.item2 : counts.item2 - counts.item1;
+		if (diff > 0)
+			return WIN_VALUE + diff;
+		if (diff < 0)
+			return -WIN_VALUE + diff;
+		return 0;
+	}
+};
+
+#endif //SEARCH_PLAYER_H
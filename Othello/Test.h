@@ -3,7 +3,6 @@
 
 #ifndef NOT_TH
 #include <thread>
-#include <mutex>
 #endif // NOT_TH
 #include <iostream>
 #include <iomanip>
@@ -15,15 +14,13 @@
 #include "WeightsOptimizer.h"
 #include "CpuGameRunner.h"
 #include "CmaEsOptimizer.h"
+#include "ThreadPool.h"
 
 class Test
 {
 public:
-	static void boardThreaded(int min, int max, int N, Othello *othello, BoardLoader *boardLoader, Board::EVALUATION_TYPE **results, int N_GAMES, int seed
-       #ifndef NOT_TH
-       , std::mutex *mtx
-       #endif // NOT_TH
-       )
+	// results - wlasna macierz N x N watku (wiersz po wierszu), scalana po zakonczeniu wszystkich watkow
+	static void boardThreaded(int min, int max, int N, Othello *othello, BoardLoader *boardLoader, Board::EVALUATION_TYPE *results, int N_GAMES, int seed)
 	{
 		Rand r(seed);
 
@@ -39,13 +36,7 @@ public:
 				{
 					Board tmpBoard(board);
 					auto res = othello->play(&tmpBoard, i, j);
-					#ifndef NOT_TH
-                    mtx->lock();
-                    #endif // NOT_TH
-					results[i][j] += res.item1;
-					#ifndef NOT_TH
-                    mtx->unlock();
-                    #endif // NOT_TH
+					results[i * N + j] += res.item1;
 				}
 			}
 		}
@@ -76,41 +67,32 @@ public:
 		}
 
 		Watch<float> watch;
-#ifndef NOT_TH
-		std::thread **th = new std::thread*[N_THREADS];
 		Othello **othellos = new Othello*[N_THREADS];
+		int *seeds = new int[N_THREADS];
 		int nBoards = conf->getBoards()->getNBoards();
-		std::mutex m;
 		for (int i = 0; i < N_THREADS; i++)
 		{
-			int min = (int)((i / (float)N_THREADS) * nBoards);
-			int max = (int)(((i + 1) / (float)N_THREADS) * nBoards);
 			othellos[i] = new Othello(players, N, r.rand());
-			th[i] = new std::thread(boardThreaded, min, max, N, othellos[i], conf->getBoards(), results, N_GAMES, r.rand(), &m);
+			seeds[i] = r.rand();
 		}
-		for (int i = 0; i < N_THREADS; i++)
+		AlignedArray<Board::EVALUATION_TYPE> *partial = createPartialResults(N_THREADS, N * N);
+		ThreadPool::getPool(N_THREADS).run(N_THREADS, [&](int i)
 		{
-			th[i]->join();
-			delete th[i];
+			int min = (int)((i / (float)N_THREADS) * nBoards);
+			int max = (int)(((i + 1) / (float)N_THREADS) * nBoards);
+			boardThreaded(min, max, N, othellos[i], conf->getBoards(), partial[i].get(), N_GAMES, seeds[i]);
+		});
+		mergePartialResults(results, partial, N_THREADS, N, N);
+		for (int i = 0; i < N_THREADS; i++)
 			delete othellos[i];
-		}
 		delete[] othellos;
-		delete[] th;
-#else
-		auto oth = new Othello(players, N, 0);
-		for (int i = 0; i < N_THREADS; i++)
-		{
-			int nBoards = conf->getBoards()->getNBoards();
-			int min = i * ((nBoards + N_THREADS - 1) / (float)N_THREADS);
-			int max = (i+1) * ((nBoards + N_THREADS - 1) / (float)N_THREADS);
-			boardThreaded(min, max, N, oth, conf->getBoards(), results, N_GAMES, r.rand());
-		}
-		delete oth;
-#endif // TH
+		delete[] seeds;
+		delete[] partial;
 		watch.stop();
 
 		int games = N_GAMES * conf->getBoards()->getNBoards();
 		printf("GPS: %f\n", games * (N - 1) * N / watch());
+		printPhases();
 		for (int i = 0; i < N; i++)
 		{
 			float val = 0;
@@ -151,11 +133,8 @@ public:
 		delete conf;
 	}
 
-    static void playersThreaded(int min, int max, int N_VALIDS, Othello *othello, BoardLoader *boardLoader, Board::EVALUATION_TYPE *results, int N_GAMES, int seed
-       #ifndef NOT_TH
-       , std::mutex *mtx
-       #endif // NOT_TH
-       )
+	// results - wlasne wyniki watku, scalane po zakonczeniu wszystkich watkow
+    static void playersThreaded(int min, int max, int N_VALIDS, Othello *othello, BoardLoader *boardLoader, Board::EVALUATION_TYPE *results, int N_GAMES, int seed)
 	{
 		Rand r(seed);
 
@@ -168,13 +147,7 @@ public:
 				{
 					Board tmpBoard(board);
 					auto res = othello->playDouble(&tmpBoard, 0, i + 1);
-					#ifndef NOT_TH
-                    mtx->lock();
-                    #endif // NOT_TH
 					results[i] += res.item1;
-					#ifndef NOT_TH
-                    mtx->unlock();
-                    #endif // NOT_TH
 				}
 			}
 		}
@@ -222,44 +195,35 @@ public:
 		}
 
 		Watch<float> watch;
+		int nBoards = validConf->getBoards()->getNBoards();
+		Othello **othellos = new Othello*[N_THREADS];
+		int *seeds = new int[N_THREADS];
 		for(int p = 0; p < N_PLAYERS; p++)
-        {
-#ifndef NOT_TH
-            std::thread **th = new std::thread*[N_THREADS];
-            Othello **othellos = new Othello*[N_THREADS];
-            int nBoards = validConf->getBoards()->getNBoards();
-            std::mutex m;
-            for (int i = 0; i < N_THREADS; i++)
-            {
-                int min = (int)((i / (float)N_THREADS) * nBoards);
-                int max = (int)(((i + 1) / (float)N_THREADS) * nBoards);
-                othellos[i] = new Othello(players[p], valids, N_VALIDS, r.rand());
-                th[i] = new std::thread(playersThreaded, min, max, N_VALIDS, othellos[i], validConf->getBoards(), results[p], N_GAMES, r.rand(), &m);
-            }
-            for (int i = 0; i < N_THREADS; i++)
-            {
-                th[i]->join();
-                delete th[i];
-                delete othellos[i];
-            }
-            delete[] othellos;
-            delete[] th;
-#else
-            auto othello = new Othello(players[p], valids, N_VALIDS, seed);
-            int nBoards = validConf->getBoards()->getNBoards();
-            for (int i = 0; i < N_THREADS; i++)
-            {
-                int min = (int)((i / (float)N_THREADS) * nBoards);
-                int max = (int)(((i + 1) / (float)N_THREADS) * nBoards);
-                playersThreaded(min, max, N_VALIDS, othello, validConf->getBoards(), results[p], N_GAMES, r.rand());
-            }
-			delete othello;
-#endif // NOT_TH
-        }
+		{
+			for (int i = 0; i < N_THREADS; i++)
+			{
+				othellos[i] = new Othello(players[p], valids, N_VALIDS, r.rand());
+				seeds[i] = r.rand();
+			}
+			AlignedArray<Board::EVALUATION_TYPE> *partial = createPartialResults(N_THREADS, N_VALIDS);
+			ThreadPool::getPool(N_THREADS).run(N_THREADS, [&](int i)
+			{
+				int min = (int)((i / (float)N_THREADS) * nBoards);
+				int max = (int)(((i + 1) / (float)N_THREADS) * nBoards);
+				playersThreaded(min, max, N_VALIDS, othellos[i], validConf->getBoards(), partial[i].get(), N_GAMES, seeds[i]);
+			});
+			mergePartialResults(&results[p], partial, N_THREADS, 1, N_VALIDS);
+			for (int i = 0; i < N_THREADS; i++)
+				delete othellos[i];
+			delete[] partial;
+		}
+		delete[] othellos;
+		delete[] seeds;
 		watch.stop();
 
 		int games = N_GAMES * validConf->getBoards()->getNBoards() * N_VALIDS;
 		printf("GPS: %f\n", games * N_PLAYERS / watch());
+		printPhases();
 		for (int i = 0; i < N_PLAYERS; i++)
 		{
 			float val = 0;
@@ -311,41 +275,38 @@ public:
 		}
 
 		Watch<float> watch;
-#ifndef NOT_TH
-		std::thread **th = new std::thread*[N_THREADS];
 		Othello **othellos = new Othello*[N_THREADS];
+		int *seeds = new int[N_THREADS];
 		int nBoards = conf->getBoards()->getNBoards();
-		std::mutex m;
 		for (int i = 0; i < N_THREADS; i++)
 		{
-			int min = 0;
-			int max = nBoards;
 			othellos[i] = new Othello(players, N, i);
-			th[i] = new std::thread(boardThreaded, min, max, N, othellos[i], conf->getBoards(), results, N_GAMES, r.rand(), &m);
+			seeds[i] = r.rand();
 		}
-		for (int i = 0; i < N_THREADS; i++)
+		AlignedArray<Board::EVALUATION_TYPE> *partial = createPartialResults(N_THREADS, N * N);
+		float *cpuTimes = new float[N_THREADS];
+		ThreadPool::getPool(N_THREADS).run(N_THREADS, [&](int i)
 		{
-			th[i]->join();
-			delete th[i];
+			ThreadWatch<float> cpuWatch;
+			boardThreaded(0, nBoards, N, othellos[i], conf->getBoards(), partial[i].get(), N_GAMES, seeds[i]);
+			cpuTimes[i] = cpuWatch.stop();
+		});
+		mergePartialResults(results, partial, N_THREADS, N, N);
+		for (int i = 0; i < N_THREADS; i++)
 			delete othellos[i];
-		}
 		delete[] othellos;
-		delete[] th;
-#else
-		auto oth = new Othello(players, N, 0);
-		for (int i = 0; i < N_THREADS; i++)
-		{
-			int nBoards = conf->getBoards()->getNBoards();
-			int min = i * ((nBoards + N_THREADS - 1) / (float)N_THREADS);
-			int max = (i+1) * ((nBoards + N_THREADS - 1) / (float)N_THREADS);
-			boardThreaded(min, max, N, oth, conf->getBoards(), results, N_GAMES, r.rand());
-		}
-		delete oth;
-#endif // TH
+		delete[] seeds;
+		delete[] partial;
 		watch.stop();
 
 		int games = N_THREADS * N_GAMES * conf->getBoards()->getNBoards();
 		printf("GPS: %f\n", games * (N - 1) * N / watch());
+		float cpuTime = 0;
+		for (int i = 0; i < N_THREADS; i++)
+			cpuTime += cpuTimes[i];
+		delete[] cpuTimes;
+		printf("Wall time: %f\tThreads CPU time: %f\n", watch(), cpuTime);
+		printPhases();
 
 		for (int i = 0; i < N; i++)
 			delete[] results[i];
@@ -357,6 +318,14 @@ public:
 		delete conf;
 	}
 
+	// Wypisuje czasy faz, jesli zostaly zmierzone (PHASE_TIMERS).
+	static void printPhases()
+	{
+#ifdef PHASE_TIMERS
+		PhaseTimers::print();
+#endif // PHASE_TIMERS
+	}
+
 	static void threadedLearner(Board::EVALUATION_TYPE *res, OthelloPlayer *player, Othello *othello, int nExperts, Board::EVALUATION_TYPE *const*pop, int nWeights, UniversalLoader *boardLoader)
 	{
 		const int N_GAMES = 1;
@@ -390,10 +359,15 @@ public:
 		Rand r(seed);
 
 		auto conf = Configuration::getConf(configFile, r.rand());
-		auto gameRunner = new SimpleCPUGameRunner(nThreads, nGames, r.rand());
+		int runnerSeed = r.rand();
+		SimpleCPUGameRunner *gameRunner = conf->getOption("batched_games", 0) != 0 ?
+			new BatchedCPUGameRunner(nThreads, nGames, runnerSeed) : new SimpleCPUGameRunner(nThreads, nGames, runnerSeed);
 		auto logger = new TxtLogger(logFile, conf, false);
 
 		optimizer->optimize(conf, gameRunner);
+		if (gameRunner->getExpertMoveCache() != nullptr)
+			gameRunner->getExpertMoveCache()->printStats();
+		gameRunner->printEvalCacheStats();
 
         delete logger;
 		delete gameRunner;
@@ -401,6 +375,26 @@ public:
 	}
 
 private:
+	// Tworzy wyzerowane tablice wynikow czesciowych dla kazdego watku. Rozmiar
+	// zaokraglany jest do pelnych linii pamieci podrecznej, aby watki nie dzielily linii.
+	static AlignedArray<Board::EVALUATION_TYPE> *createPartialResults(int nThreads, int size)
+	{
+		const int PER_LINE = CACHE_LINE_SIZE / sizeof(Board::EVALUATION_TYPE);
+		AlignedArray<Board::EVALUATION_TYPE> *partial = new AlignedArray<Board::EVALUATION_TYPE>[nThreads];
+		for (int i = 0; i < nThreads; i++)
+			partial[i].resize((size + PER_LINE - 1) / PER_LINE * PER_LINE);
+		return partial;
+	}
+
+	// Dodaje wyniki czesciowe watkow (w kolejnosci watkow) do macierzy rows x cols.
+	static void mergePartialResults(Board::EVALUATION_TYPE **results, AlignedArray<Board::EVALUATION_TYPE> *partial, int nThreads, int rows, int cols)
+	{
+		for (int t = 0; t < nThreads; t++)
+			for (int i = 0; i < rows; i++)
+				for (int j = 0; j < cols; j++)
+					results[i][j] += partial[t][i * cols + j];
+	}
+
 #ifndef NOT_TH
     template<typename P1, typename P2 = P1>
 #else
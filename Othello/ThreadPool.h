@@ -0,0 +1,157 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <functional>
+#include <vector>
+#include <assert.h>
+#ifndef NOT_TH
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#endif // NOT_TH
+
+// Wspolna dla calego procesu pula watkow roboczych.
+// Watki tworzone sa raz i czekaja na kolejne paczki zadan, dzieki czemu
+// kolejne generacje optymalizacji nie placa za tworzenie i niszczenie watkow.
+// Bez obslugi watkow (NOT_TH) zadania wykonywane sa kolejno w watku wywolujacym.
+// Pula wykonuje naraz jedna paczke, a run trzyma ja do zakonczenia wszystkich zadan,
+// wiec zadanie nie moze wywolywac getPool ani run (zakleszczenie) - sprawdza to assert.
+class ThreadPool
+{
+public:
+	// Zwraca pule procesu, zapewniajac w niej co najmniej nThreads watkow.
+	static ThreadPool &getPool(int nThreads)
+	{
+		assert(!isInsidePool());
+		static ThreadPool pool;
+		pool.reserve(nThreads);
+		return pool;
+	}
+
+	// Wykonuje zadania 0..nTasks-1 i czeka na zakonczenie wszystkich.
+	// Zadania pobierane sa przez wolne watki w kolejnosci numerow.
+	void run(int nTasks, const std::function<void(int)> &task)
+	{
+		assert(!isInsidePool());
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> submitLock(submitMutex);
+		std::unique_lock<std::mutex> lock(mutex);
+		this->task = &task;
+		this->nTasks = nTasks;
+		nextTask = 0;
+		nWorking = (int)workers.size();
+		generation++;
+		wakeUp.notify_all();
+		done.wait(lock, [this] { return nWorking == 0; });
+		this->task = nullptr;
+#else
+		isInsidePool() = true;
+		for (int i = 0; i < nTasks; i++)
+			task(i);
+		isInsidePool() = false;
+#endif // NOT_TH
+	}
+
+	// Czy biezacy watek wykonuje zadanie puli.
+	static bool &isInsidePool()
+	{
+		static thread_local bool inside = false;
+		return inside;
+	}
+
+	int getNThreads()
+	{
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> submitLock(submitMutex);
+		return (int)workers.size();
+#else
+		return 1;
+#endif // NOT_TH
+	}
+
+	~ThreadPool()
+	{
+#ifndef NOT_TH
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wakeUp.notify_all();
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i]->join();
+		for (size_t i = 0; i < workers.size(); i++)
+			delete workers[i];
+#endif // NOT_TH
+	}
+private:
+#ifndef NOT_TH
+	std::vector<std::thread *> workers;
+	// Chroni przed rownoczesnym zlecaniem paczek z kilku watkow.
+	std::mutex submitMutex;
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable done;
+	const std::function<void(int)> *task;
+	int nTasks;
+	std::atomic<int> nextTask;
+	// Liczba watkow, ktore nie zakonczyly jeszcze biezacej paczki.
+	int nWorking;
+	// Numer biezacej paczki zadan.
+	unsigned generation;
+	bool stopping;
+#endif // NOT_TH
+
+	ThreadPool()
+	{
+#ifndef NOT_TH
+		task = nullptr;
+		nTasks = 0;
+		nextTask = 0;
+		nWorking = 0;
+		generation = 0;
+		stopping = false;
+#endif // NOT_TH
+	}
+
+	ThreadPool(const ThreadPool &);
+	ThreadPool &operator=(const ThreadPool &);
+
+	void reserve(int nThreads)
+	{
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> submitLock(submitMutex);
+		std::lock_guard<std::mutex> lock(mutex);
+		while ((int)workers.size() < nThreads)
+			workers.push_back(new std::thread(&ThreadPool::work, this, generation));
+#endif // NOT_TH
+	}
+
+#ifndef NOT_TH
+	void work(unsigned seen)
+	{
+		isInsidePool() = true;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			wakeUp.wait(lock, [this, seen] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+			const std::function<void(int)> *f = task;
+			int n = nTasks;
+			lock.unlock();
+
+			int t;
+			while ((t = nextTask.fetch_add(1)) < n)
+				(*f)(t);
+
+			lock.lock();
+			if (--nWorking == 0)
+				done.notify_all();
+		}
+	}
+#endif // NOT_TH
+};
+
+#endif //THREAD_POOL_H
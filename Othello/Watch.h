@@ -1,50 +1,84 @@
 #ifndef WATCH_H
 #define WATCH_H
 
-//#define ACCURATE_WATCH
-
-#ifdef ACCURATE_WATCH
-#include <sys/time.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include <memory>
+#ifndef NOT_TH
+#include <mutex>
+#include <atomic>
+#endif // NOT_TH
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
 #else
 #include <time.h>
 #endif
 
+// Mierzy czas rzeczywisty (zegar monotoniczny), niezalezny od liczby watkow.
 template <typename T> class Watch
 {
-#ifdef ACCURATE_WATCH
-	struct timeval begin;
-	struct timeval end;
-#else
-	clock_t begin;
-	clock_t end;
-#endif
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point begin;
 	T res;
 public:
 	Watch()
 	{
+		res = 0;
 		start();
 	}
 
 	void start()
 	{
-#ifdef ACCURATE_WATCH
-		gettimeofday(&begin, NULL);
-#else
-		begin = clock();
-#endif
+		begin = Clock::now();
 	}
 
 	T stop()
 	{
-#ifdef ACCURATE_WATCH
-		gettimeofday(&end, NULL);
-		int64_t t = end.tv_usec + 1000000LL * end.tv_sec;
-		t -= begin.tv_usec + 1000000LL * begin.tv_sec;
-		res = static_cast<T>(t) / 1000000LL;
-#else
-		end = clock();
-		res = static_cast<T> (end - begin) / CLOCKS_PER_SEC;
-#endif
+		res = current();
+		return res;
+	}
+
+	T operator()(int mul = 1)
+	{
+		return res*mul;
+	}
+
+	T current()
+	{
+		return std::chrono::duration_cast<std::chrono::duration<T> >(Clock::now() - begin).count();
+	}
+
+	// Biezacy odczyt zegara w nanosekundach.
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+	}
+};
+
+// Mierzy czas procesora zuzyty przez biezacy watek.
+// Obiekt nalezy uruchamiac i zatrzymywac w tym samym watku.
+template <typename T> class ThreadWatch
+{
+	int64_t begin;
+	T res;
+public:
+	ThreadWatch()
+	{
+		res = 0;
+		start();
+	}
+
+	void start()
+	{
+		begin = now();
+	}
+
+	T stop()
+	{
+		res = current();
 		return res;
 	}
 
@@ -55,17 +89,177 @@ public:
 
 	T current()
 	{
-		#ifdef ACCURATE_WATCH
-		struct timeval c;
-		gettimeofday(&c, NULL);
-		int64_t t = c.tv_usec + 1000000LL * c.tv_sec;
-		t -= begin.tv_usec + 1000000LL * begin.tv_sec;
-		return static_cast<T>(t) / 1000000LL;
-		#else
-		clock_t c = clock();
-		return static_cast<T> (c - begin) / CLOCKS_PER_SEC;
-		#endif
+		return static_cast<T>(now() - begin) / 1000000000LL;
+	}
+
+	// Czas procesora biezacego watku w nanosekundach.
+	static int64_t now()
+	{
+#if defined(WIN32) || defined(_WIN32)
+		FILETIME creation, exit, kernel, user;
+		GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+		int64_t k = ((int64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+		int64_t u = ((int64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+		return (k + u) * 100;
+#else
+		struct timespec t;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+		return t.tv_nsec + 1000000000LL * t.tv_sec;
+#endif
 	}
 };
 
+// Czas rzeczywisty spedzony w nazwanych fazach programu, sumowany ze wszystkich watkow.
+// Pomiary wlaczane sa flaga PHASE_TIMERS (makro PHASE_TIMER), bez niej nic nie kosztuja.
+// Kazdy watek zapisuje wlasne liczniki, wiec pomiar nie wymaga synchronizacji.
+class PhaseTimers
+{
+public:
+	enum Phase
+	{
+		MOVE_GENERATION,
+		EVALUATION,
+		OPTIMIZER_UPDATE,
+		IO,
+		N_PHASES
+	};
+
+	static const char *getName(int phase)
+	{
+		static const char *names[N_PHASES] = { "move_generation", "evaluation", "optimizer_update", "io" };
+		return names[phase];
+	}
+
+	static void add(int phase, int64_t ns)
+	{
+		Counters *c = getCounters();
+		c->ns[phase] += ns;
+		c->count[phase] += 1;
+	}
+
+	// Laczny czas fazy w sekundach.
+	static double getSeconds(int phase)
+	{
+		return getTotal(phase, true) / 1e9;
+	}
+
+	// Liczba pomiarow fazy.
+	static int64_t getCount(int phase)
+	{
+		return getTotal(phase, false);
+	}
+
+	static void reset()
+	{
+		Registry &r = getRegistry();
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> lock(r.mutex);
+#endif // NOT_TH
+		for (size_t i = 0; i < r.counters.size(); i++)
+			for (int p = 0; p < N_PHASES; p++)
+			{
+				r.counters[i]->ns[p] = 0;
+				r.counters[i]->count[p] = 0;
+			}
+	}
+
+	static void print(FILE *file = stdout)
+	{
+		for (int p = 0; p < N_PHASES; p++)
+			fprintf(file, "phase %-16s %12.6f s %14lld\n", getName(p), getSeconds(p), (long long)getCount(p));
+	}
+private:
+	// Liczniki jednego watku. Zapisuje je tylko wlasciciel, pozostale watki jedynie czytaja.
+	struct Counters
+	{
+#ifndef NOT_TH
+		std::atomic<int64_t> ns[N_PHASES];
+		std::atomic<int64_t> count[N_PHASES];
+#else
+		int64_t ns[N_PHASES];
+		int64_t count[N_PHASES];
+#endif // NOT_TH
+
+		Counters()
+		{
+			for (int p = 0; p < N_PHASES; p++)
+			{
+				ns[p] = 0;
+				count[p] = 0;
+			}
+		}
+	};
+
+	struct Registry
+	{
+		std::vector<std::unique_ptr<Counters> > counters;
+#ifndef NOT_TH
+		std::mutex mutex;
+#endif // NOT_TH
+	};
+
+	static Registry &getRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	static Counters *getCounters()
+	{
+#ifndef NOT_TH
+		static thread_local Counters *counters = nullptr;
+#else
+		static Counters *counters = nullptr;
+#endif // NOT_TH
+		if (counters == nullptr)
+		{
+			Registry &r = getRegistry();
+#ifndef NOT_TH
+			std::lock_guard<std::mutex> lock(r.mutex);
+#endif // NOT_TH
+			r.counters.push_back(std::unique_ptr<Counters>(new Counters()));
+			counters = r.counters.back().get();
+		}
+		return counters;
+	}
+
+	static int64_t getTotal(int phase, bool time)
+	{
+		Registry &r = getRegistry();
+#ifndef NOT_TH
+		std::lock_guard<std::mutex> lock(r.mutex);
+#endif // NOT_TH
+		int64_t total = 0;
+		for (size_t i = 0; i < r.counters.size(); i++)
+			total += time ? r.counters[i]->ns[phase] : r.counters[i]->count[phase];
+		return total;
+	}
+};
+
+// Dodaje czas zycia obiektu do wskazanej fazy.
+class PhaseTimer
+{
+	int phase;
+	int64_t begin;
+public:
+	PhaseTimer(int phase)
+	{
+		this->phase = phase;
+		begin = Watch<double>::now();
+	}
+
+	~PhaseTimer()
+	{
+		PhaseTimers::add(phase, Watch<double>::now() - begin);
+	}
+};
+
+#define PHASE_TIMER_NAME_(line) phaseTimer##line
+#define PHASE_TIMER_NAME(line) PHASE_TIMER_NAME_(line)
+#ifdef PHASE_TIMERS
+#define PHASE_TIMER(phase) PhaseTimer PHASE_TIMER_NAME(__LINE__)(PhaseTimers::phase)
+#else
+#define PHASE_TIMER(phase)
+#endif // PHASE_TIMERS
+
 #endif //WATCH_H
@@ -10,6 +10,7 @@
 #include "Othello.h"
 #include "OthelloPlayer.h"
 #include "Random.h"
+#include "Watch.h"
 #include "IterationsStrategy.h"
 #include "GameRunner.h"
 #include "OptimizerConfiguration.h"
@@ -30,6 +31,7 @@ public:
 protected:
 	void saveWeights(const std::string &weightsFile, const std::string &bestWeightsFile, Board::EVALUATION_TYPE *weights, int nWeights, int totalIterations, int *iterations, int nLevels, Board::EVALUATION_TYPE result, bool isBest)
 	{
+		PHASE_TIMER(IO);
 		FILE *file = fopen(weightsFile.c_str(), "w");
 		fprintf(file, "%d ", totalIterations);
 		for(int i = 0; i < nLevels; i++)
@@ -51,6 +53,7 @@ protected:
 
 	void loadWeights(const std::string &weightsFile, const std::string &bestWeightsFile, Board::EVALUATION_TYPE **weights, Board::EVALUATION_TYPE *bestEvaluation, int nWeights, int *totalIterations, int *iterations, int nIterations)
 	{
+		PHASE_TIMER(IO);
 		Board::EVALUATION_TYPE *w = new Board::EVALUATION_TYPE[nWeights];
 		*weights = w;
 		FILE *file = fopen(weightsFile.c_str(), "r");
@@ -0,0 +1,101 @@
+#ifndef WORK_STEALING_SCHEDULER_H
+#define WORK_STEALING_SCHEDULER_H
+
+#include <functional>
+#include <vector>
+#ifndef NOT_TH
+#include <mutex>
+#endif // NOT_TH
+#include "AlignedArray.h"
+#include "ThreadPool.h"
+
+// Rozdziela zadania 0..nTasks-1 pomiedzy nWorkers robotnikow z kradzieza pracy.
+// Kazdy robotnik dostaje na poczatku ciagly przedzial zadan i wykonuje go od poczatku,
+// a po jego wyczerpaniu przejmuje gorna polowe pozostalych zadan innego robotnika.
+// Robotnik o numerze w wykonywany jest zawsze przez jeden watek, wiec zadania moga
+// korzystac ze stanu przypisanego do numeru robotnika (gracze, Othello).
+class WorkStealingScheduler
+{
+public:
+	static void run(int nWorkers, int nTasks, const std::function<void(int task, int worker)> &task)
+	{
+		if (nWorkers < 1)
+			nWorkers = 1;
+
+		std::vector<TaskRange> ranges(nWorkers);
+		for (int w = 0; w < nWorkers; w++)
+		{
+			ranges[w].begin = (int)((long long)nTasks * w / nWorkers);
+			ranges[w].end = (int)((long long)nTasks * (w + 1) / nWorkers);
+		}
+
+		ThreadPool::getPool(nWorkers).run(nWorkers, [&](int w)
+		{
+			int t;
+			while (ranges[w].pop(&t) || steal(ranges, w, &t))
+				task(t, w);
+		});
+	}
+private:
+	// Przedzial zadan robotnika, zajmujacy osobna linie pamieci podrecznej.
+	struct TaskRange
+	{
+		int begin;
+		int end;
+#ifndef NOT_TH
+		std::mutex mutex;
+#endif // NOT_TH
+		char padding[CACHE_LINE_SIZE];
+
+		TaskRange() : begin(0), end(0) { }
+
+		TaskRange(const TaskRange &other) : begin(other.begin), end(other.end) { }
+
+		// Pobiera pierwsze zadanie z przedzialu.
+		bool pop(int *task)
+		{
+#ifndef NOT_TH
+			std::lock_guard<std::mutex> lock(mutex);
+#endif // NOT_TH
+			if (begin >= end)
+				return false;
+			*task = begin++;
+			return true;
+		}
+	};
+
+	// Przejmuje gorna polowe zadan pierwszego robotnika, ktory je jeszcze ma,
+	// i zwraca pierwsze z przejetych.
+	static bool steal(std::vector<TaskRange> &ranges, int thief, int *task)
+	{
+		int n = (int)ranges.size();
+		for (int i = 1; i < n; i++)
+		{
+			TaskRange &victim = ranges[(thief + i) % n];
+			int begin, end;
+			{
+#ifndef NOT_TH
+				std::lock_guard<std::mutex> lock(victim.mutex);
+#endif // NOT_TH
+				int remaining = victim.end - victim.begin;
+				if (remaining <= 0)
+					continue;
+				begin = victim.end - (remaining + 1) / 2;
+				end = victim.end;
+				victim.end = begin;
+			}
+
+			TaskRange &own = ranges[thief];
+#ifndef NOT_TH
+			std::lock_guard<std::mutex> lock(own.mutex);
+#endif // NOT_TH
+			*task = begin;
+			own.begin = begin + 1;
+			own.end = end;
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif //WORK_STEALING_SCHEDULER_H
@@ -0,0 +1,61 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+
+// Klucze Zobrista pol planszy (numer bitu (y-1)*8+(x-1)) dla pionow czarnych (0)
+// i bialych (1) oraz klucz ruchu bialych. Wspolne dla wszystkich implementacji
+// planszy, wiec ta sama pozycja ma zawsze ten sam skrot.
+// Wartosci wygenerowane generatorem splitmix64.
+template <typename T>
+struct ZobristTables
+{
+	static const T KEYS[2][64];
+	static const T SIDE;
+};
+
+template <typename T>
+const T ZobristTables<T>::KEYS[2][64] =
+{
+	{
+		0xab3909931403fa94ULL, 0x37bf5b29e516fcc9ULL, 0x5d1db7ee5c30aba8ULL, 0xa764014845bed4f8ULL,
+		0x3434c1c2cfb2d7cfULL, 0x19cc2caf823b868cULL, 0x94c08fcfca36a225ULL, 0xa32b05b70cda7f1aULL,
+		0xb61c458777d1cf08ULL, 0xa466f14dc5b85d09ULL, 0x03537cf45409760bULL, 0x577453ae3566bf46ULL,
+		0x17e8ae07c56b0bd5ULL, 0xc73f9709c4733001ULL, 0x695401b3afd9b388ULL, 0x12d46db69d4aa34eULL,
+		0xa96b25d832d485e0ULL, 0xc92ccae9f77f5defULL, 0x92801a248f086bc0ULL, 0xe98ba7f4789d2463ULL,
+		0x19154d0ef0d92aa6ULL, 0xb4161dc78c61f4fbULL, 0x45427eb3fb41fa2eULL, 0x641d0788c4c3285bULL,
+		0xca2fd45d48806c9cULL, 0x1d837e654ffc86c6ULL, 0xe51144190d43005dULL, 0xc759c38bce39d9f8ULL,
+		0x4b8238e6aeb0b0fdULL, 0xc64f4cafd8bde0e3ULL, 0x6066659a8ab03630ULL, 0xb880390f21343309ULL,
+		0xd6cf01fcaf326ffbULL, 0x2581478988cbfa26ULL, 0x71cadbefe0dc04faULL, 0xa8f6ae8b95a9a34dULL,
+		0x1129387b88f9c77fULL, 0x7899fbd0b50f8145ULL, 0x9928a53ffebaea5cULL, 0x249375a382b90a26ULL,
+		0xc1284bacea18d1a5ULL, 0x85aeb59c2302c6c8ULL, 0x52538c7d54896767ULL, 0xcbd4e3edc39039b6ULL,
+		0x43f02aac6d655b9dULL, 0xc54d97fd367e110fULL, 0xd48dc8808b348dbaULL, 0xfa4cc8667a54c749ULL,
+		0xea4bf9534442e875ULL, 0x3a21d681ef8f8ba5ULL, 0xc37f93965485bb25ULL, 0x57ffac77928e680aULL,
+		0xf8e55464af8f36f6ULL, 0x28351f3aab64e943ULL, 0x514783acbe88c0b0ULL, 0x761bdc202468dfa6ULL,
+		0x79ee6f3804a2f923ULL, 0xb4eff7e42fc91996ULL, 0xa17c7753e8994033ULL, 0x27cc798cf6727966ULL,
+		0x272856cdb67cf790ULL, 0xb780d7896edc62aaULL, 0x19c7458e90feb83dULL, 0x56ac1a0ba929373aULL,
+	},
+	{
+		0x56d892052b102eefULL, 0xc6e8cff3b0b11262ULL, 0xc7ac0f5972b3ff5eULL, 0xb6e4d1baba32866bULL,
+		0x6e7c78915f15fc0cULL, 0x342cf07d82350e42ULL, 0xd034ab259adee2cdULL, 0x59deb6d314330af4ULL,
+		0xd138a2a168668e05ULL, 0x5ab2ea40388c1657ULL, 0x776dca0928e19b38ULL, 0xd9f0187079224f0dULL,
+		0xe83fd5a5ac685e21ULL, 0x12cd6bb683094fc7ULL, 0xb17804a1ee437646ULL, 0x977934f3352eea32ULL,
+		0xbaaa5094febe78dcULL, 0xabee5662f9a777ccULL, 0x5503678bfe3b5643ULL, 0x7338e884f5e800c3ULL,
+		0x21b575be16351bacULL, 0x4af0fda6ee412d73ULL, 0xee8e9e5249b4ddeeULL, 0xb649b6057fbc8becULL,
+		0x32cd8a73464da780ULL, 0x620caa82e7ff52b9ULL, 0x94489fb4371b543eULL, 0x528f5bb7e98390d1ULL,
+		0x3f2f41aeaaf2667dULL, 0x6cedd5ef7f160560ULL, 0xcde00294ec571844ULL, 0x67ca834b6c3eae80ULL,
+		0x179eb8ed3f4ee41cULL, 0x5166b0dcbf6ea2ebULL, 0x57762670d371dc25ULL, 0x284706e7aa5734f2ULL,
+		0xf101523a57954fa6ULL, 0x71fa28c5f7a23dbaULL, 0xcff7b8882367d874ULL, 0x8b73fac7781c350cULL,
+		0x6ce69fb79a89aaafULL, 0x90909c634d8f51fdULL, 0x8b9e2ca0aa72b1f4ULL, 0xc3c8d703368f2e65ULL,
+		0xa20d2f3dc4bf9a03ULL, 0xcf165ea6606a4a32ULL, 0xaa9d2847d27da266ULL, 0xc670b34e46c5f926ULL,
+		0x94985e6ec5414dbcULL, 0xafac08002000cdbfULL, 0x081c86fa24506724ULL, 0xfb8da5f576566659ULL,
+		0xe61dc81328f1e26bULL, 0x78250d98880b583bULL, 0xd15b3d8923325f68ULL, 0xdaa1e231e4bb8203ULL,
+		0xbc2a39fc8c88e514ULL, 0x4ac502c669447744ULL, 0x0278d0e2d0ac344bULL, 0xe7f309cc9cdf337eULL,
+		0xe3fb918c78ef89fbULL, 0x32580bb1b9ddf5e5ULL, 0x48cbb99263475bc9ULL, 0x90e71943777a6d2aULL,
+	},
+};
+
+template <typename T>
+const T ZobristTables<T>::SIDE = 0xf5c65eedd382fa8eULL;
+
+#endif //ZOBRIST_H
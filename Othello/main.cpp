@@ -3,6 +3,10 @@
 #include <stdio.h>
 #include "Header.h"
 #include "Test.h"
+#include "Benchmark.h"
+#include "Perft.h"
+#include "EndgameSolver.h"
+#include "OpeningBookBuilder.h"
 #include "TupleLoader.h"
 #if defined(WIN32) || defined(_WIN32)
 #include <windows.h>
@@ -39,13 +43,16 @@ void run(int argc, const char *argv[], AbsCmaEsOptimizer *(*f)(int N_ITERATIONS,
     auto seed = atoi(argv[9]);
 
     auto vconf = Configuration::getConf(validConf, 0);
-    auto vgameRunner = new SimpleCPUGameRunner(nTh, nGames, 0);
+    SimpleCPUGameRunner *vgameRunner = vconf->getOption("batched_games", 0) != 0 ?
+        new BatchedCPUGameRunner(nTh, nGames, 0) : new SimpleCPUGameRunner(nTh, nGames, 0);
     vgameRunner->init(vconf);
 
     Rand r(seed);
 
     auto config = Configuration::getConf(conf, r.rand());
-    auto gameRunner = new SimpleCPUGameRunner(nTh, nGames, r.rand());
+    int runnerSeed = r.rand();
+    SimpleCPUGameRunner *gameRunner = config->getOption("batched_games", 0) != 0 ?
+        new BatchedCPUGameRunner(nTh, nGames, runnerSeed) : new SimpleCPUGameRunner(nTh, nGames, runnerSeed);
     auto logger = new TxtLogger(log, config, false);
 
     int nIt = 24 * 4 * 4000 / (nGames * nTh);
@@ -59,6 +66,9 @@ void run(int argc, const char *argv[], AbsCmaEsOptimizer *(*f)(int N_ITERATIONS,
 
     w.stop();
     printf("Total time: %f\n", w());
+#ifdef PHASE_TIMERS
+    PhaseTimers::print();
+#endif // PHASE_TIMERS
 
     delete logger;
     delete gameRunner;
@@ -427,6 +437,143 @@ int main(int argc, const char *argv[])
             nThreads = atoi(argv[4]);
         Test::performanceTest(conf, seed, nThreads);
     }
+    else if (strcmp(argv[1], "perft") == 0)
+    {
+        if (argc < 3)
+        {
+            printf("Not less then 1 parameter needed\n");
+            printf("type, depth (, boards)\n");
+            return 0;
+        }
+        BoardLoader *boards = nullptr;
+        if (argc > 3)
+            boards = BoardLoader::getLoader(argv[3]);
+        Perft::run<Board>(atoi(argv[2]), boards);
+        delete boards;
+    }
+    else if (strcmp(argv[1], "perft_diff") == 0)
+    {
+        if (argc < 4)
+        {
+            printf("Not less then 2 parameters needed\n");
+            printf("type, nGames, seed (, boards)\n");
+            return 0;
+        }
+        BoardLoader *boards = nullptr;
+        if (argc > 4)
+            boards = BoardLoader::getLoader(argv[4]);
+        int nGames = atoi(argv[2]);
+        int played = Perft::compare<MailboxBoard, BitBoard>(nGames, atoi(argv[3]), boards);
+        delete boards;
+        return played == nGames ? 0 : 1;
+    }
+    else if (strcmp(argv[1], "endgame") == 0)
+    {
+        if (argc < 3)
+        {
+            printf("Not less then 1 parameter needed\n");
+            printf("type, nEmpties (, boards, nPositions=20, seed=0)\n");
+            return 0;
+        }
+        BoardLoader *boards = nullptr;
+        if (argc > 3)
+            boards = BoardLoader::getLoader(argv[3]);
+        int nPositions = argc > 4 ? atoi(argv[4]) : 20;
+        int seed = argc > 5 ? atoi(argv[5]) : 0;
+        EndgameSolver::benchmark(boards, atoi(argv[2]), nPositions, seed);
+        delete boards;
+    }
+    else if (strcmp(argv[1], "search_smp") == 0)
+    {
+        if (argc < 5)
+        {
+            printf("Not less then 3 parameters needed\n");
+            printf("type, player, depth, maxThreads (, boards, nPositions=20, nPlies=20, seed=0)\n");
+            return 0;
+        }
+        BoardLoader *boards = nullptr;
+        if (argc > 5)
+            boards = BoardLoader::getLoader(argv[5]);
+        int nPositions = argc > 6 ? atoi(argv[6]) : 20;
+        int nPlies = argc > 7 ? atoi(argv[7]) : 20;
+        int seed = argc > 8 ? atoi(argv[8]) : 0;
+        SearchPlayer::benchmark(argv[2], atoi(argv[3]), atoi(argv[4]), boards, nPositions, nPlies, seed);
+        delete boards;
+    }
+    else if (strcmp(argv[1], "book") == 0)
+    {
+        if (argc < 6)
+        {
+            printf("Not less then 4 parameters needed\n");
+            printf("type, config, book, nGames, maxPlies (, nThreads=8, randomFreq=0.1, minGames=2, seed=0, positions)\n");
+            return 0;
+        }
+        int nThreads = argc > 6 ? atoi(argv[6]) : 8;
+        float randomFreq = argc > 7 ? (float)atof(argv[7]) : 0.1f;
+        int minGames = argc > 8 ? atoi(argv[8]) : 2;
+        int seed = argc > 9 ? atoi(argv[9]) : 0;
+        Configuration *conf = Configuration::getConf(argv[2], seed);
+        if (conf == nullptr)
+            return 1;
+        Watch<double> watch;
+        OpeningBookBuilder builder(conf, atoi(argv[5]), randomFreq, seed);
+        builder.play(atoi(argv[4]), nThreads);
+        OpeningBook *book = builder.getBook(minGames);
+        bool saved = book->save(argv[3]);
+        printf("book games %d positions %d moves %d start positions %d time %f s\n", builder.getNGames(), book->getNPositions(),
+            book->getNEntries(), builder.getNPositions(), watch.stop());
+        if (saved && argc > 10)
+            saved = builder.savePositions(argv[10]);
+        delete book;
+        delete conf;
+        if (!saved)
+            return 1;
+    }
+    else if (strcmp(argv[1], "mcts") == 0)
+    {
+        if (argc < 5)
+        {
+            printf("Not less then 3 parameters needed\n");
+            printf("type, player, playouts, maxThreads (, boards, nPositions=20, nPlies=20, seed=0, randomFreq=0, target=0)\n");
+            return 0;
+        }
+        BoardLoader *boards = nullptr;
+        if (argc > 5)
+            boards = BoardLoader::getLoader(argv[5]);
+        int nPositions = argc > 6 ? atoi(argv[6]) : 20;
+        int nPlies = argc > 7 ? atoi(argv[7]) : 20;
+        int seed = argc > 8 ? atoi(argv[8]) : 0;
+        float randomFreq = argc > 9 ? (float)atof(argv[9]) : 0;
+        double target = argc > 10 ? atof(argv[10]) : 0;
+        double rate = MctsPlayer::benchmark(argv[2], atoll(argv[3]), atoi(argv[4]), boards, nPositions, nPlies, seed, randomFreq);
+        delete boards;
+        if (rate < target)
+        {
+            printf("mcts playouts/s %f below target %f\n", rate, target);
+            return 1;
+        }
+    }
+    else if (strcmp(argv[1], "bench") == 0)
+    {
+        if (argc < 4)
+        {
+            printf("Not less then 2 parameters needed\n");
+            printf("type, config, seed (, nThreads=8, nSamples=10)\n");
+            return 0;
+        }
+        auto seed = atoi(argv[3]);
+        int nThreads = 8;
+        if (argc > 4)
+            nThreads = atoi(argv[4]);
+        int nSamples = 10;
+        if (argc > 5)
+            nSamples = atoi(argv[5]);
+        Rand r(seed);
+        auto conf = Configuration::getConf(argv[2], r.rand());
+        Benchmark benchmark(conf, r.rand(), nThreads, nSamples);
+        benchmark.runAll();
+        fprintf(stderr, "checksum: %g\n", benchmark.getSink());
+    }
     else if (strcmp(argv[1], "convert") == 0)
     {
         if (argc != 5)